@@ -0,0 +1,241 @@
+/**
+ * Sheet benchmark
+ *
+ * Measures throughput of sheet on synthetic tables (results are written as CSV for tracking of regressions)
+ *
+ * @author Michal Šmahel <xsmahe01@stud.fit.vutbr.cz>
+ * @date October-November 2020
+ * @version 1.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench_common.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/**
+ * @def MIN_BENCH_COLUMNS Minimum number of columns of the generated table (pipelines use columns 1-5)
+ */
+#define MIN_BENCH_COLUMNS 5
+/**
+ * @def streq(first, second) Check if first equals second
+ */
+#define streq(first, second) (strcmp(first, second) == 0)
+
+/**
+ * @typedef Settings of the benchmark
+ * @field sheet Path to sheet executable
+ * @field rows Number of rows of the generated table
+ * @field columns Number of columns of the generated table
+ * @field width Maximum width of cells
+ * @field delimiters Delimiters (the first one is the main one, others are used randomly in the table)
+ * @field threads Number of threads of sheet (-j option)
+ * @field repeats Number of runs of each pipeline (the fastest one is reported)
+ */
+typedef struct benchSettings {
+    const char *sheet;
+    int rows;
+    int columns;
+    int width;
+    const char *delimiters;
+    int threads;
+    int repeats;
+} BenchSettings;
+/**
+ * @typedef Measured pipeline
+ * @field name Name of the pipeline in results
+ * @field arguments Functions for sheet (separated by spaces)
+ * @field operations Number of functions (and selections) of the pipeline
+ */
+typedef struct pipeline {
+    const char *name;
+    const char *arguments;
+    int operations;
+} Pipeline;
+
+/**
+ * @var pipelines Representative pipelines (their columns exist in every generated table)
+ */
+const Pipeline pipelines[] = {
+        {"cset", "cset 2 bench", 1},
+        {"copy", "copy 1 3", 1},
+        {"swap", "swap 2 4", 1},
+        {"move", "move 5 1", 1},
+        {"dcols_icol", "dcols 2 3 icol 1 acol", 3},
+        {"contains", "contains 3 ab cset 1 x", 2},
+        {"round", "round 1", 1},
+        {"toupper", "toupper 2 4", 1},
+};
+
+// Prototypes
+bool parseBenchArguments(BenchSettings *settings, int argc, char **argv);
+bool runPipeline(const BenchSettings *settings, const Pipeline *pipeline, int tableFd, double *seconds);
+void writeBenchError(const char *message);
+
+/**
+ * Main function
+ * @param argc Number of program arguments
+ * @param argv Program arguments
+ * @return Exit code
+ */
+int main(int argc, char **argv) {
+    BenchSettings settings = {NULL, 200000, 8, 8, " ", 1, 3};
+    if (parseBenchArguments(&settings, argc, argv) == false) {
+        writeBenchError("Pouziti: sheet_bench SHEET [-r RADKY] [-c SLOUPCE] [-w SIRKA] [-d ODDELOVACE] [-j VLAKNA] "
+                        "[-n OPAKOVANI]");
+
+        return EXIT_FAILURE;
+    }
+
+    // Table is generated only once and all pipelines read it
+    char path[] = "/tmp/sheet_bench_XXXXXX";
+    int tableFd = mkstemp(path);
+    if (tableFd < 0) {
+        writeBenchError("Nepodarilo se vytvorit soubor s tabulkou.");
+
+        return EXIT_FAILURE;
+    }
+    unlink(path);
+
+    long long size;
+    TableShape shape = {settings.rows, 0, settings.columns, settings.width, settings.delimiters};
+    if (generateTable(&shape, tableFd, &size) == false) {
+        writeBenchError("Nepodarilo se vygenerovat tabulku.");
+        close(tableFd);
+
+        return EXIT_FAILURE;
+    }
+
+    printf("pipeline,rows,columns,bytes,threads,seconds,rows_per_s,mb_per_s,ns_per_row_op\n");
+    int numberOfPipelines = (int)(sizeof(pipelines) / sizeof(Pipeline));
+    for (int i = 0; i < numberOfPipelines; i++) {
+        const Pipeline *pipeline = &pipelines[i];
+
+        double seconds;
+        if (runPipeline(&settings, pipeline, tableFd, &seconds) == false) {
+            writeBenchError("Beh sheet selhal.");
+            close(tableFd);
+
+            return EXIT_FAILURE;
+        }
+
+        printf("%s,%d,%d,%lld,%d,%.6f,%.0f,%.2f,%.2f\n", pipeline->name, settings.rows, settings.columns, size,
+               settings.threads, seconds, settings.rows / seconds, size / seconds / 1e6,
+               seconds * 1e9 / settings.rows / pipeline->operations);
+        fflush(stdout);
+    }
+
+    close(tableFd);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Parses program arguments into benchmark settings
+ * @param settings Settings to fill (they contain default values)
+ * @param argc Number of program arguments
+ * @param argv Program arguments
+ * @return Are the arguments valid?
+ */
+bool parseBenchArguments(BenchSettings *settings, int argc, char **argv) {
+    if (argc < 2) {
+        return false;
+    }
+    settings->sheet = argv[1];
+
+    // Options have always a value
+    for (int i = 2; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            return false;
+        }
+
+        const char *option = argv[i];
+        if (streq(option, "-d")) {
+            settings->delimiters = argv[i + 1];
+            if (settings->delimiters[0] == '\0') {
+                return false;
+            }
+
+            continue;
+        }
+
+        int value = (int)strtol(argv[i + 1], NULL, 10);
+        if (value < 1) {
+            return false;
+        }
+
+        if (streq(option, "-r")) {
+            settings->rows = value;
+        } else if (streq(option, "-c")) {
+            settings->columns = value;
+        } else if (streq(option, "-w")) {
+            settings->width = value;
+        } else if (streq(option, "-j")) {
+            settings->threads = value;
+        } else if (streq(option, "-n")) {
+            settings->repeats = value;
+        } else {
+            return false;
+        }
+    }
+
+    return settings->columns >= MIN_BENCH_COLUMNS;
+}
+
+/**
+ * Runs sheet with the pipeline on the generated table
+ * @param settings Settings of the benchmark
+ * @param pipeline Pipeline to run
+ * @param tableFd File with the table
+ * @param seconds Time of the fastest run
+ * @return Did all runs succeed?
+ */
+bool runPipeline(const BenchSettings *settings, const Pipeline *pipeline, int tableFd, double *seconds) {
+    // Arguments are the same for all runs
+    char functions[BENCH_FUNCTIONS_SIZE];
+    char threads[16];
+    char *argv[MAX_BENCH_ARGS + 1];
+
+    snprintf(threads, sizeof(threads), "%d", settings->threads);
+    const char *options[] = {"-d", settings->delimiters, "-j", threads, NULL};
+    prepareSheetArguments(argv, functions, settings->sheet, options, pipeline->arguments);
+
+    *seconds = 0;
+    for (int i = 0; i < settings->repeats; i++) {
+        if (lseek(tableFd, 0, SEEK_SET) < 0) {
+            return false;
+        }
+
+        double start = getTime();
+        pid_t pid = startSheet(settings->sheet, argv, tableFd);
+        if (pid < 0) {
+            return false;
+        }
+
+        int status;
+        if (waitpid(pid, &status, 0) < 0 || WIFEXITED(status) == false || WEXITSTATUS(status) != 0) {
+            return false;
+        }
+
+        double time = getTime() - start;
+        if (i == 0 || time < *seconds) {
+            *seconds = time;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Writes error message to standard error output
+ * @param message Error message
+ */
+void writeBenchError(const char *message) {
+    fprintf(stderr, "sheet_bench: %s\n", message);
+}
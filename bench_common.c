@@ -0,0 +1,146 @@
+/**
+ * Sheet benchmark - shared parts
+ *
+ * Generator of synthetic tables and runner of sheet used by sheet_bench and sheet_perf
+ *
+ * @author Michal Šmahel <xsmahe01@stud.fit.vutbr.cz>
+ * @date October-November 2020
+ * @version 1.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench_common.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+/**
+ * Generates synthetic table (the first column has decimal numbers, others have random words)
+ * @param shape Shape of the table
+ * @param fd File to write the table to
+ * @param size Size of the generated table (in bytes)
+ * @return Was the table generated?
+ */
+bool generateTable(const TableShape *shape, int fd, long long *size) {
+    FILE *table = fdopen(dup(fd), "w");
+    char *row = malloc(shape->columns * (shape->width + 1) + 16);
+    if (table == NULL || row == NULL) {
+        if (table != NULL) {
+            fclose(table);
+        }
+        free(row);
+
+        return false;
+    }
+
+    // Letters are mostly from the start of alphabet, so selections match only some rows
+    const char letters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJ";
+    int numberOfOthers = (int)strlen(shape->delimiters) - 1;
+    unsigned int state = 2020;
+    *size = 0;
+    for (int number = 0; (shape->rows == 0 || number < shape->rows) && (shape->minSize == 0 || *size < shape->minSize);
+         number++) {
+        int length = sprintf(row, "%u.%02u", nextRandom(&state) % 100000, nextRandom(&state) % 100);
+
+        for (int column = 1; column < shape->columns; column++) {
+            // Other delimiters are unified by sheet, so they're used only sometimes
+            char delimiter = shape->delimiters[0];
+            if (numberOfOthers > 0 && nextRandom(&state) % 4 == 0) {
+                delimiter = shape->delimiters[1 + nextRandom(&state) % numberOfOthers];
+            }
+            row[length++] = delimiter;
+
+            int width = 1 + (int)(nextRandom(&state) % shape->width);
+            for (int i = 0; i < width; i++) {
+                row[length++] = letters[nextRandom(&state) % (sizeof(letters) - 1)];
+            }
+        }
+        row[length++] = '\n';
+
+        fwrite(row, 1, length, table);
+        *size += length;
+    }
+    free(row);
+
+    bool written = ferror(table) == 0;
+
+    return fclose(table) == 0 && written == true && *size > 0;
+}
+
+/**
+ * Generates next pseudo-random number (xorshift, so tables are the same for all runs)
+ * @param state State of the generator
+ * @return Pseudo-random number
+ */
+unsigned int nextRandom(unsigned int *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+
+    return *state;
+}
+
+/**
+ * Prepares arguments of sheet (options first, then functions split by spaces)
+ * @param argv Array for the arguments (MAX_BENCH_ARGS + 1 items, it's terminated by NULL)
+ * @param buffer Buffer for the split functions (BENCH_FUNCTIONS_SIZE bytes, arguments point to it)
+ * @param sheet Path to sheet executable
+ * @param options Options of sheet with their values (terminated by NULL)
+ * @param functions Functions for sheet (separated by spaces)
+ * @return Number of the arguments
+ */
+int prepareSheetArguments(char **argv, char *buffer, const char *sheet, const char *const *options,
+                          const char *functions) {
+    int argc = 0;
+    argv[argc++] = (char *)sheet;
+    for (int i = 0; options[i] != NULL && argc < MAX_BENCH_ARGS; i++) {
+        argv[argc++] = (char *)options[i];
+    }
+
+    snprintf(buffer, BENCH_FUNCTIONS_SIZE, "%s", functions);
+    for (char *argument = strtok(buffer, " "); argument != NULL && argc < MAX_BENCH_ARGS;
+         argument = strtok(NULL, " ")) {
+        argv[argc++] = argument;
+    }
+    argv[argc] = NULL;
+
+    return argc;
+}
+
+/**
+ * Starts sheet in a child process (its output is thrown away, only the cost of producing it is interesting)
+ * @param sheet Path to sheet executable
+ * @param argv Arguments of sheet (see prepareSheetArguments())
+ * @param inputFd File for standard input of sheet (negative to keep the standard input)
+ * @return Process of sheet (negative if it can't be started)
+ */
+pid_t startSheet(const char *sheet, char **argv, int inputFd) {
+    pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+
+    int null = open("/dev/null", O_WRONLY);
+    if (null < 0 || (inputFd >= 0 && dup2(inputFd, STDIN_FILENO) < 0) || dup2(null, STDOUT_FILENO) < 0) {
+        _exit(127);
+    }
+
+    execv(sheet, argv);
+    _exit(127);
+}
+
+/**
+ * Returns actual time of monotonic clock
+ * @return Time in seconds
+ */
+double getTime(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
@@ -0,0 +1,51 @@
+/**
+ * Sheet benchmark - shared parts
+ *
+ * Generator of synthetic tables and runner of sheet used by sheet_bench and sheet_perf (their results are comparable
+ * only while they measure the same tables in the same way)
+ *
+ * @author Michal Šmahel <xsmahe01@stud.fit.vutbr.cz>
+ * @date October-November 2020
+ * @version 1.0
+ */
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+/**
+ * @def MAX_BENCH_ARGS Maximum number of arguments of sheet for one run
+ */
+#define MAX_BENCH_ARGS 32
+/**
+ * @def BENCH_FUNCTIONS_SIZE Size of buffer for functions of sheet (they're split into arguments in it)
+ */
+#define BENCH_FUNCTIONS_SIZE 256
+
+/**
+ * @typedef Shape of the generated table
+ * @field rows Number of rows (0 if the table is limited by its size only)
+ * @field minSize Minimum size of the table (in bytes; 0 if the table is limited by rows only, the last row is whole)
+ * @field columns Number of columns
+ * @field width Maximum width of cells
+ * @field delimiters Delimiters (the first one is the main one, others are used randomly in the table)
+ */
+typedef struct tableShape {
+    int rows;
+    long long minSize;
+    int columns;
+    int width;
+    const char *delimiters;
+} TableShape;
+
+bool generateTable(const TableShape *shape, int fd, long long *size);
+unsigned int nextRandom(unsigned int *state);
+int prepareSheetArguments(char **argv, char *buffer, const char *sheet, const char *const *options,
+                          const char *functions);
+pid_t startSheet(const char *sheet, char **argv, int inputFd);
+double getTime(void);
+
+#endif
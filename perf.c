@@ -0,0 +1,453 @@
+/**
+ * Sheet performance test
+ *
+ * Runs sheet end to end on generated datasets and compares results with a stored baseline (it fails on regressions)
+ *
+ * @author Michal Šmahel <xsmahe01@stud.fit.vutbr.cz>
+ * @date October-November 2020
+ * @version 1.0
+ */
+
+#define _DEFAULT_SOURCE // wait4() (peak RSS of each run)
+
+#include "bench_common.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/**
+ * @def MAX_BASELINE_RESULTS Maximum number of results in the baseline file
+ */
+#define MAX_BASELINE_RESULTS 256
+/**
+ * @def RESULT_NAME_SIZE Size of names of datasets and pipelines in results (including \0)
+ */
+#define RESULT_NAME_SIZE 32
+/**
+ * @def streq(first, second) Check if first equals second
+ */
+#define streq(first, second) (strcmp(first, second) == 0)
+
+/**
+ * @typedef Settings of the performance test
+ * @field sheet Path to sheet executable
+ * @field megabytes Size of each dataset (in MB)
+ * @field repeats Number of runs of each pipeline (the fastest one is reported)
+ * @field threshold Allowed difference from the baseline (in percent)
+ * @field baseline Path to the baseline file (NULL if results aren't compared)
+ */
+typedef struct perfSettings {
+    const char *sheet;
+    int megabytes;
+    int repeats;
+    int threshold;
+    const char *baseline;
+} PerfSettings;
+/**
+ * @typedef Generated dataset
+ * @field name Name of the dataset in results
+ * @field columns Number of columns (pipelines use columns 1-5)
+ * @field width Maximum width of cells
+ * @field delimiters Delimiters (the first one is the main one, others are used randomly in the table)
+ */
+typedef struct dataset {
+    const char *name;
+    int columns;
+    int width;
+    const char *delimiters;
+} Dataset;
+/**
+ * @typedef Measured pipeline
+ * @field name Name of the pipeline in results
+ * @field arguments Functions for sheet (separated by spaces)
+ */
+typedef struct pipeline {
+    const char *name;
+    const char *arguments;
+} Pipeline;
+/**
+ * @typedef Result of one pipeline on one dataset
+ * @field dataset Name of the dataset
+ * @field pipeline Name of the pipeline
+ * @field bytes Size of the dataset
+ * @field seconds Wall time of the fastest run
+ * @field peakRss Peak resident set size of sheet (in KB, the biggest one of all runs)
+ * @field syscalls Number of read and write system calls of sheet (the biggest one of all runs)
+ */
+typedef struct perfResult {
+    char dataset[RESULT_NAME_SIZE];
+    char pipeline[RESULT_NAME_SIZE];
+    long long bytes;
+    double seconds;
+    long long peakRss;
+    long long syscalls;
+} PerfResult;
+
+/**
+ * @var datasets Generated datasets (they're generated one by one, so only one of them is on disk)
+ */
+const Dataset datasets[] = {
+        {"narrow", 6, 6, " "},
+        {"wide", 120, 4, " "},
+        {"delimiters", 10, 6, " ,;:|"},
+};
+/**
+ * @var pipelines Fixed pipelines, one for each family of functions (see getFunctionFromArgs() in sheet.c)
+ */
+const Pipeline pipelines[] = {
+        {"table_editing", "irow 1 10 drows 2 100 arow 10"},
+        {"column_editing", "icol 2 dcols 4 5 acol"},
+        {"cset", "cset 2 perf"},
+        {"case", "tolower 2 4"},
+        {"round", "round 1"},
+        {"int", "int 1"},
+        {"copy", "copy 1 3"},
+        {"swap", "swap 2 4"},
+        {"move", "move 5 1"},
+        {"rows", "rows 100 - cset 3 x"},
+        {"beginswith", "beginswith 2 a toupper 2"},
+        {"contains", "contains 3 ab cset 1 x"},
+};
+
+// Prototypes
+bool parsePerfArguments(PerfSettings *settings, int argc, char **argv);
+bool runPipeline(const PerfSettings *settings, const Dataset *dataset, const Pipeline *pipeline, int datasetFd,
+                 PerfResult *result);
+long long getSyscalls(pid_t pid);
+int loadBaseline(const char *path, PerfResult *results);
+bool saveBaseline(const char *path, const PerfResult *results, int numberOfResults);
+const char *compareWithBaseline(const PerfResult *result, const PerfResult *baseline, int numberOfBaseline,
+                                int threshold);
+void writePerfError(const char *message);
+
+/**
+ * Main function
+ * @param argc Number of program arguments
+ * @param argv Program arguments
+ * @return Exit code (it's a failure if some result is worse than the baseline)
+ */
+int main(int argc, char **argv) {
+    PerfSettings settings = {NULL, 1024, 3, 10, NULL};
+    if (parsePerfArguments(&settings, argc, argv) == false) {
+        writePerfError("Pouziti: sheet_perf SHEET [-s MB] [-n OPAKOVANI] [-t PROCENTA] [-b ZAKLAD]");
+
+        return EXIT_FAILURE;
+    }
+
+    // Missing baseline is created by this run
+    PerfResult *baseline = malloc(MAX_BASELINE_RESULTS * sizeof(PerfResult));
+    int numberOfDatasets = (int)(sizeof(datasets) / sizeof(Dataset));
+    int numberOfPipelines = (int)(sizeof(pipelines) / sizeof(Pipeline));
+    PerfResult *results = malloc(numberOfDatasets * numberOfPipelines * sizeof(PerfResult));
+    if (baseline == NULL || results == NULL) {
+        writePerfError("Nedostatek pameti pro vysledky.");
+        free(baseline);
+        free(results);
+
+        return EXIT_FAILURE;
+    }
+    int numberOfBaseline = settings.baseline != NULL ? loadBaseline(settings.baseline, baseline) : 0;
+
+    printf("dataset,pipeline,bytes,seconds,mb_per_s,peak_rss_kb,io_syscalls_per_gb,baseline_mb_per_s,status\n");
+    int numberOfResults = 0;
+    int regressions = 0;
+    bool failed = false;
+    for (int i = 0; i < numberOfDatasets && failed == false; i++) {
+        const Dataset *dataset = &datasets[i];
+
+        // Dataset is unlinked at once, sheet opens it through its descriptor (so it's mapped as a regular file)
+        char path[] = "/tmp/sheet_perf_XXXXXX";
+        int datasetFd = mkstemp(path);
+        if (datasetFd < 0) {
+            writePerfError("Nepodarilo se vytvorit soubor s tabulkou.");
+            failed = true;
+            break;
+        }
+        unlink(path);
+
+        long long size;
+        TableShape shape = {0, settings.megabytes * 1000000LL, dataset->columns, dataset->width, dataset->delimiters};
+        if (generateTable(&shape, datasetFd, &size) == false) {
+            writePerfError("Nepodarilo se vygenerovat tabulku.");
+            close(datasetFd);
+            failed = true;
+            break;
+        }
+
+        for (int j = 0; j < numberOfPipelines; j++) {
+            PerfResult *result = &results[numberOfResults];
+            result->bytes = size;
+            if (runPipeline(&settings, dataset, &pipelines[j], datasetFd, result) == false) {
+                writePerfError("Beh sheet selhal.");
+                failed = true;
+                break;
+            }
+            numberOfResults++;
+
+            const char *status = compareWithBaseline(result, baseline, numberOfBaseline, settings.threshold);
+            if (streq(status, "regression")) {
+                regressions++;
+            }
+
+            double baselineSpeed = 0;
+            for (int k = 0; k < numberOfBaseline; k++) {
+                if (streq(baseline[k].dataset, result->dataset) && streq(baseline[k].pipeline, result->pipeline)) {
+                    baselineSpeed = baseline[k].bytes / baseline[k].seconds / 1e6;
+                }
+            }
+
+            printf("%s,%s,%lld,%.6f,%.2f,%lld,%.0f,%.2f,%s\n", result->dataset, result->pipeline, result->bytes,
+                   result->seconds, result->bytes / result->seconds / 1e6, result->peakRss,
+                   result->syscalls * 1e9 / result->bytes, baselineSpeed, status);
+            fflush(stdout);
+        }
+
+        close(datasetFd);
+    }
+
+    if (failed == false && settings.baseline != NULL && numberOfBaseline == 0 &&
+        saveBaseline(settings.baseline, results, numberOfResults) == false) {
+        writePerfError("Nepodarilo se ulozit zakladni vysledky.");
+        failed = true;
+    }
+
+    free(baseline);
+    free(results);
+
+    if (failed == false && regressions > 0) {
+        fprintf(stderr, "sheet_perf: Vykon se zhorsil v %d merenich.\n", regressions);
+        failed = true;
+    }
+
+    return failed == true ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * Parses program arguments into settings of the performance test
+ * @param settings Settings to fill (they contain default values)
+ * @param argc Number of program arguments
+ * @param argv Program arguments
+ * @return Are the arguments valid?
+ */
+bool parsePerfArguments(PerfSettings *settings, int argc, char **argv) {
+    if (argc < 2) {
+        return false;
+    }
+    settings->sheet = argv[1];
+
+    // Options have always a value
+    for (int i = 2; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            return false;
+        }
+
+        const char *option = argv[i];
+        if (streq(option, "-b")) {
+            settings->baseline = argv[i + 1];
+
+            continue;
+        }
+
+        int value = (int)strtol(argv[i + 1], NULL, 10);
+        if (value < 1) {
+            return false;
+        }
+
+        if (streq(option, "-s")) {
+            settings->megabytes = value;
+        } else if (streq(option, "-n")) {
+            settings->repeats = value;
+        } else if (streq(option, "-t")) {
+            settings->threshold = value;
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Runs sheet with the pipeline on the dataset
+ * @param settings Settings of the performance test
+ * @param dataset Dataset in the file
+ * @param pipeline Pipeline to run
+ * @param datasetFd File with the dataset (it's inherited by sheet)
+ * @param result Result to fill (bytes are already set)
+ * @return Did all runs succeed?
+ */
+bool runPipeline(const PerfSettings *settings, const Dataset *dataset, const Pipeline *pipeline, int datasetFd,
+                 PerfResult *result) {
+    snprintf(result->dataset, RESULT_NAME_SIZE, "%s", dataset->name);
+    snprintf(result->pipeline, RESULT_NAME_SIZE, "%s", pipeline->name);
+
+    // Arguments are the same for all runs
+    char functions[BENCH_FUNCTIONS_SIZE];
+    char input[32];
+    char *argv[MAX_BENCH_ARGS + 1];
+
+    snprintf(input, sizeof(input), "/dev/fd/%d", datasetFd);
+    const char *options[] = {"-d", dataset->delimiters, "-f", input, NULL};
+    prepareSheetArguments(argv, functions, settings->sheet, options, pipeline->arguments);
+
+    result->seconds = 0;
+    result->peakRss = 0;
+    result->syscalls = 0;
+    for (int i = 0; i < settings->repeats; i++) {
+        double start = getTime();
+        pid_t pid = startSheet(settings->sheet, argv, -1);
+        if (pid < 0) {
+            return false;
+        }
+
+        // Finished sheet is kept as a zombie until its counters are read
+        siginfo_t info;
+        if (waitid(P_PID, pid, &info, WEXITED | WNOWAIT) < 0) {
+            return false;
+        }
+        double time = getTime() - start;
+        long long syscalls = getSyscalls(pid);
+
+        int status;
+        struct rusage usage;
+        if (wait4(pid, &status, 0, &usage) < 0 || WIFEXITED(status) == false || WEXITSTATUS(status) != 0) {
+            return false;
+        }
+
+        if (i == 0 || time < result->seconds) {
+            result->seconds = time;
+        }
+        if (usage.ru_maxrss > result->peakRss) {
+            result->peakRss = usage.ru_maxrss;
+        }
+        if (syscalls > result->syscalls) {
+            result->syscalls = syscalls;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Returns number of read and write system calls of the finished process (from its I/O accounting in /proc)
+ * @param pid Process (zombie that hasn't been waited for yet)
+ * @return Number of the system calls (0 if they can't be read)
+ */
+long long getSyscalls(pid_t pid) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/io", (int)pid);
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+
+    char line[128];
+    long long syscalls = 0;
+    long long value;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (sscanf(line, "syscr: %lld", &value) == 1 || sscanf(line, "syscw: %lld", &value) == 1) {
+            syscalls += value;
+        }
+    }
+    fclose(file);
+
+    return syscalls;
+}
+
+/**
+ * Loads results from the baseline file (written by saveBaseline())
+ * @param path Path to the baseline file
+ * @param results Array for loaded results (MAX_BASELINE_RESULTS items)
+ * @return Number of loaded results (0 if the file doesn't exist)
+ */
+int loadBaseline(const char *path, PerfResult *results) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+
+    // Header is skipped (it doesn't match the format)
+    char line[256];
+    int numberOfResults = 0;
+    while (numberOfResults < MAX_BASELINE_RESULTS && fgets(line, sizeof(line), file) != NULL) {
+        PerfResult *result = &results[numberOfResults];
+        if (sscanf(line, "%31[^,],%31[^,],%lld,%lf,%lld,%lld", result->dataset, result->pipeline, &result->bytes,
+                   &result->seconds, &result->peakRss, &result->syscalls) == 6 && result->seconds > 0) {
+            numberOfResults++;
+        }
+    }
+    fclose(file);
+
+    return numberOfResults;
+}
+
+/**
+ * Saves results as the baseline for next runs
+ * @param path Path to the baseline file
+ * @param results Results to save
+ * @param numberOfResults Number of the results
+ * @return Was the file written?
+ */
+bool saveBaseline(const char *path, const PerfResult *results, int numberOfResults) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+
+    fprintf(file, "dataset,pipeline,bytes,seconds,peak_rss_kb,io_syscalls\n");
+    for (int i = 0; i < numberOfResults; i++) {
+        const PerfResult *result = &results[i];
+        fprintf(file, "%s,%s,%lld,%.6f,%lld,%lld\n", result->dataset, result->pipeline, result->bytes,
+                result->seconds, result->peakRss, result->syscalls);
+    }
+
+    bool written = ferror(file) == 0;
+
+    return fclose(file) == 0 && written == true;
+}
+
+/**
+ * Compares the result with the same measurement of the baseline
+ * @param result Result of this run
+ * @param baseline Results of the baseline
+ * @param numberOfBaseline Number of results of the baseline
+ * @param threshold Allowed difference (in percent)
+ * @return Status of the result: "ok", "regression" (throughput, peak RSS or system calls are worse than the threshold
+ *         allows) or "new" (there isn't any comparable result in the baseline)
+ */
+const char *compareWithBaseline(const PerfResult *result, const PerfResult *baseline, int numberOfBaseline,
+                                int threshold) {
+    for (int i = 0; i < numberOfBaseline; i++) {
+        const PerfResult *base = &baseline[i];
+        if (!(streq(base->dataset, result->dataset)) || !(streq(base->pipeline, result->pipeline))) {
+            continue;
+        }
+
+        // Peak RSS and number of system calls depend on size of the dataset
+        if (base->bytes != result->bytes) {
+            return "new";
+        }
+
+        double allowed = threshold / 100.0;
+        bool slower = result->seconds > base->seconds * (1 + allowed);
+        bool bigger = result->peakRss > base->peakRss * (1 + allowed);
+        bool chattier = result->syscalls > base->syscalls * (1 + allowed);
+
+        return slower == true || bigger == true || chattier == true ? "regression" : "ok";
+    }
+
+    return "new";
+}
+
+/**
+ * Writes error message to standard error output
+ * @param message Error message
+ */
+void writePerfError(const char *message) {
+    fprintf(stderr, "sheet_perf: %s\n", message);
+}
@@ -8,23 +8,121 @@
  * @version 1.0
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <limits.h>
+#include <float.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @def X86_SIMD Are SSE2/AVX2 kernels available? (they can be turned off by defining DISABLE_SIMD)
+ * @def NEON_SIMD Are NEON kernels available?
+ */
+#if !defined(DISABLE_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define X86_SIMD
+#include <immintrin.h>
+#elif !defined(DISABLE_SIMD) && defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_NEON)
+#define NEON_SIMD
+#include <arm_neon.h>
+#endif
 
 /**
- * @def MAX_ROW_SIZE Maximum size of one row (in bytes)
+ * @def GZIP_SUPPORTED Can be input and output compressed by gzip? (zlib is used if ENABLE_ZLIB is defined)
+ */
+#ifdef ENABLE_ZLIB
+#define GZIP_SUPPORTED true
+#include <zlib.h>
+#else
+#define GZIP_SUPPORTED false
+#endif
+
+/**
+ * @def ARENA_BLOCK_SIZE Size of the first block of row's memory (next blocks are always twice bigger; in bytes)
+ */
+#define ARENA_BLOCK_SIZE (64 * 1024)
+/**
+ * @def INPUT_BLOCK_SIZE Size of input buffer, input is read in blocks of this size (in bytes)
+ */
+#define INPUT_BLOCK_SIZE (1024 * 1024)
+/**
+ * @def OUTPUT_BUFFER_SIZE Size of output buffer, output is written in blocks of this size (in bytes)
+ */
+#define OUTPUT_BUFFER_SIZE (1024 * 1024)
+/**
+ * @def MAX_THREADS Maximum number of threads for parallel processing (-j option)
+ */
+#define MAX_THREADS 256
+/**
+ * @def CHUNKS_PER_THREAD Number of chunks in processing for each thread (some of them are waiting to be written)
+ */
+#define CHUNKS_PER_THREAD 2
+/**
+ * @def PIPELINE_CHUNKS Number of chunks in the ring of pipelined processing (--pipeline option)
+ */
+#define PIPELINE_CHUNKS 4
+/**
+ * @def DECOMPRESSED_BLOCKS Number of blocks of decompressed input prepared in advance by decompressing thread
+ */
+#define DECOMPRESSED_BLOCKS 4
+/**
+ * @def COMPRESSION_LEVEL Level of gzip compression of output (the fastest one, so compression keeps up with processing)
+ */
+#define COMPRESSION_LEVEL 1
+/**
+ * @def GZIP_SUFFIX Suffix of names of gzip compressed files (they're decompressed or compressed automatically)
+ */
+#define GZIP_SUFFIX ".gz"
+/**
+ * @def MAX_SIMD_DELIMITERS Maximum number of delimiters for SIMD kernels (more delimiters are processed by look-up table)
+ */
+#define MAX_SIMD_DELIMITERS 8
+/**
+ * @def MAX_EXACT_DIGITS Maximum number of digits of decimal number, which is stored exactly enough in double that
+ *      rounding of its digits gives the same result as rounding of the double
+ */
+#define MAX_EXACT_DIGITS 15
+/**
+ * @def MAX_EXACT_RESULT_SIZE Maximum size of rounded plain decimal number (digits, sign, carry and \0)
+ */
+#define MAX_EXACT_RESULT_SIZE (MAX_EXACT_DIGITS + 3)
+/**
+ * @def BATCH_SIZE Number of rows processed together by data processing function (multiple of 64, see Batch)
+ */
+#define BATCH_SIZE 1024
+/**
+ * @def INDEX_STEP Offset of every N-th row is stored in the row index (--index option)
+ */
+#define INDEX_STEP 1024
+/**
+ * @def INDEX_MAGIC Identification of the row index file format (there are no terminating \0 in the file)
  */
-#define MAX_ROW_SIZE 10 * 1024
+#define INDEX_MAGIC "SHEETIX1"
 /**
- * @def MAX_CELL_SIZE Maximum size of table cell (in bytes)
+ * @def MAX_CELL_OVERRIDES Maximum number of overridden cells of a read-only row (other changes move it to its storage)
  */
-#define MAX_CELL_SIZE 100
+#define MAX_CELL_OVERRIDES 2
 /**
  * @def MAX_FUNCTIONS Maximum functions in program input arguments
  */
 #define MAX_FUNCTIONS 100
+/**
+ * @def MAX_BRANCHES Maximum number of branches of processing (standard output and outputs of --tee options)
+ */
+#define MAX_BRANCHES 16
+/**
+ * @def STATS_SAMPLE_INTERVAL Times are measured for every N-th row only (--stats option), other rows are only counted
+ */
+#define STATS_SAMPLE_INTERVAL 64
 /**
  * @def DEFAULT_DELIMITER Default delimiter for case user didn't set different
  */
@@ -41,6 +139,10 @@
  * @def NO_SELECTION No selection function set
  */
 #define NO_SELECTION -1
+/**
+ * @def NEW_COLUMN Mark of a new (empty) column in a table layout (input columns are numbered from 1)
+ */
+#define NEW_COLUMN 0
 /**
  * @def LOWER_CASE Flag for lower case style
  */
@@ -56,20 +158,214 @@
 #define streq(first, second) strcmp(first, second) == 0
 
 /**
- * @typedef Row Individual row for processing
- * @field data Row content
+ * @typedef ArenaBlock Block of arena's memory
+ * @field previous Previously used (smaller) block
+ * @field capacity Size of block's memory
+ * @field used Number of already allocated bytes of block's memory
+ * @field memory Block's memory
+ */
+typedef struct arenaBlock {
+    struct arenaBlock *previous;
+    size_t capacity;
+    size_t used;
+    char memory[];
+} ArenaBlock;
+/**
+ * @typedef Arena Memory for data of the processed row (it isn't freed after every row, it's only reset)
+ * @field block Currently used block (blocks grow geometrically, only the biggest one is kept after reset)
+ */
+typedef struct arena {
+    ArenaBlock *block;
+} Arena;
+/**
+ * @typedef CellOverride New value of a cell of read-only row (it's written instead of the cell, see setColumnValue())
+ * @field column Number of the overridden cell
+ * @field value New value of the cell (terminated by \0; it's valid until the row is written, see setColumnValue())
+ * @field size Size of the new value
+ */
+typedef struct cellOverride {
+    int column;
+    const char *value;
+    int size;
+} CellOverride;
+/**
+ * @typedef Row Individual row for processing (fields used by every function are at the start)
+ * @field data Row content (points to input buffer or to storage if the row had to grow)
+ * @field cells Start positions of cells in data (cells[numberOfCells] is the end of the last cell + 1)
  * @field size Row size (number of contained chars)
+ * @field numberOfCells Number of cells (columns) in the row
  * @field number Row number (from 1)
+ * @field readOnly Can't be data changed in place? (they're in read-only memory, so they must be moved to storage)
  * @field deleted Is the row mark as deleted?
  * @field last Is this row the last?
+ * @field outOfMemory Has some allocation of row's memory failed? (the row can't be processed correctly)
+ * @field storage Own memory for row content (allocated from arena when needed)
+ * @field storageCapacity Size of the storage
+ * @field cellsCapacity Number of items in cells
+ * @field arena Memory for storage, cells and cells' values (it's reset before loading of each row or batch of rows,
+ *        rows of a batch share it)
+ * @field overrides Changed cells of read-only row (its data stay in the input buffer; only the one data processing
+ *        function changes them and nothing reads the cells after it, so they're used only by writeProcessedRow())
+ * @field numberOfOverrides Number of overridden cells
  */
 typedef struct row {
-    char data[MAX_ROW_SIZE];
+    char *data;
+    int *cells;
     int size;
+    int numberOfCells;
     int number;
+    bool readOnly;
     bool deleted;
     bool last;
+    bool outOfMemory;
+    char *storage;
+    int storageCapacity;
+    int cellsCapacity;
+    Arena *arena;
+    CellOverride overrides[MAX_CELL_OVERRIDES];
+    int numberOfOverrides;
 } Row;
+/**
+ * @typedef RowIndex Index of rows of the mapped input file (it's saved to a sidecar file for later runs)
+ * @field offsets Offsets of every INDEX_STEP-th row (offsets[i] is the start of row number i * INDEX_STEP + 1)
+ * @field numberOfOffsets Number of offsets
+ * @field numberOfRows Number of rows of the input
+ * @field numberOfColumns Number of columns of every row (only valid tables are indexed)
+ */
+typedef struct rowIndex {
+    size_t *offsets;
+    size_t numberOfOffsets;
+    int numberOfRows;
+    int numberOfColumns;
+} RowIndex;
+/**
+ * @typedef IndexHeader Header of the row index file (offsets follow it; the file is valid only for the same version of
+ *          the input file and the same delimiters)
+ * @field magic Identification of the file format (INDEX_MAGIC)
+ * @field step Step of indexed rows (INDEX_STEP)
+ * @field inputSize Size of the input file
+ * @field modified Time of the last modification of the input file (in nanoseconds)
+ * @field classes Classes of chars for used delimiters (see Delimiters)
+ * @field numberOfRows Number of rows of the input
+ * @field numberOfColumns Number of columns of every row
+ * @field numberOfOffsets Number of offsets after the header
+ * @field checksum Checksum of the offsets (see getIndexChecksum())
+ */
+typedef struct indexHeader {
+    char magic[sizeof(INDEX_MAGIC) - 1];
+    int step;
+    long long inputSize;
+    long long modified;
+    unsigned char classes[UCHAR_MAX + 1];
+    int numberOfRows;
+    int numberOfColumns;
+    size_t numberOfOffsets;
+    unsigned long long checksum;
+} IndexHeader;
+#ifdef ENABLE_ZLIB
+/**
+ * @typedef Decompressor Decompression of gzip input in its own thread (it overlaps with processing of rows)
+ * @field fd File descriptor of the compressed input
+ * @field stream State of decompression
+ * @field compressed Buffer for compressed data
+ * @field blocks Ring of blocks of decompressed data (INPUT_BLOCK_SIZE bytes each)
+ * @field sizes Number of decompressed bytes in blocks
+ * @field first Index of the first block waiting for reading
+ * @field count Number of blocks waiting for reading
+ * @field position Number of already read bytes of the first block (it's used only by reading)
+ * @field ended Has the last gzip member ended? (otherwise the end of compressed input is unexpected)
+ * @field finished Has the whole input been decompressed? (or has decompression failed)
+ * @field failed Has decompression failed? (corrupted data or failed read)
+ * @field stopped Should decompressing thread stop? (the input is closed before its end)
+ * @field thread Decompressing thread
+ * @field lock Lock of the ring of blocks
+ * @field changed Condition signalled when a block is decompressed or read
+ */
+typedef struct decompressor {
+    int fd;
+    z_stream stream;
+    unsigned char *compressed;
+    char *blocks[DECOMPRESSED_BLOCKS];
+    size_t sizes[DECOMPRESSED_BLOCKS];
+    int first;
+    int count;
+    size_t position;
+    bool ended;
+    bool finished;
+    bool failed;
+    bool stopped;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} Decompressor;
+/**
+ * @typedef Compressor Gzip compression of output (data are compressed when the output buffer is flushed)
+ * @field stream State of compression
+ * @field buffer Buffer for compressed data (OUTPUT_BUFFER_SIZE bytes)
+ */
+typedef struct compressor {
+    z_stream stream;
+    unsigned char *buffer;
+} Compressor;
+#else
+typedef struct decompressor Decompressor;
+typedef struct compressor Compressor;
+#endif
+/**
+ * @typedef Input Input data loaded in big blocks (or mapped into memory at once)
+ * @field fd File descriptor of the input
+ * @field buffer Loaded data
+ * @field capacity Size of the buffer
+ * @field size Number of loaded bytes in the buffer
+ * @field position Position of the first byte that hasn't been used for any row yet
+ * @field mapped Is the whole input in the buffer? (mapped input file or chunk of input - it can't be refilled)
+ * @field readOnly Can't be data in the buffer changed? (rows are moved to their storage before changes)
+ * @field partial Is it only a part of the input? (its end isn't the end of the whole input or it isn't known yet)
+ * @field failed Has loading failed? (there isn't enough memory for a very long row)
+ * @field lookahead Must be known if a row is the last one when it's loaded? (see needsLastRow(), otherwise the next
+ *        data aren't read in advance)
+ * @field numberOfColumns Number of columns of every row (found by validateTable(); 0 if rows haven't been validated)
+ * @field index Index of rows (NULL if the input isn't indexed, see openRowIndex())
+ * @field decompressor Decompression of the input (NULL if the input isn't compressed, see openDecompressor())
+ * @field corrupted Has decompression of the input failed? (rows after the failure are missing)
+ */
+typedef struct input {
+    int fd;
+    char *buffer;
+    size_t capacity;
+    size_t size;
+    size_t position;
+    bool mapped;
+    bool readOnly;
+    bool partial;
+    bool failed;
+    bool lookahead;
+    int numberOfColumns;
+    const RowIndex *index;
+    Decompressor *decompressor;
+    bool corrupted;
+} Input;
+/**
+ * @typedef Output Output data collected in a big buffer and written at once
+ * @field fd File descriptor of the output
+ * @field buffer Data waiting for writing
+ * @field capacity Size of the buffer
+ * @field size Number of bytes waiting in the buffer
+ * @field lineBuffered Should the data be written after every row? (otherwise when the buffer is full)
+ * @field failed Did some write fail?
+ * @field written Number of bytes written to the file so far
+ * @field compressor Compression of the output (NULL if the output isn't compressed, see openCompressor())
+ */
+typedef struct output {
+    int fd;
+    char *buffer;
+    int capacity;
+    int size;
+    bool lineBuffered;
+    bool failed;
+    long long written;
+    Compressor *compressor;
+} Output;
 /**
  * @typedef Error information tells how some action ended
  * @field error Did it end with error? (=> if true, something bad happened; otherwise the operation was successful)
@@ -91,66 +387,542 @@ typedef struct inputArguments {
     int skipped;
 } InputArguments;
 /**
- * @typedef Program defined function for row selection
+ * @typedef Class of input char (for classification of chars by look-up table)
+ */
+typedef enum charClass {
+    OTHER_CHAR,
+    DELIMITER_CHAR, // Delimiter that must be replaced with the main one
+    MAIN_DELIMITER_CHAR,
+    NEW_LINE_CHAR,
+} CharClass;
+/**
+ * @typedef Delimiters Used cell delimiters prepared for classification of chars (built once from -d option)
+ * @field main Main delimiter (all other delimiters are replaced with it)
+ * @field classes Classes of all chars (indexed by unsigned value of the char)
+ * @field others Other delimiters (without duplicates and the main delimiter)
+ * @field numberOfOthers Number of other delimiters
+ * @field indexCells Kernel for indexing cells (selected by CPU features, see indexCellsScalar())
+ */
+typedef struct delimiters {
+    char main;
+    unsigned char classes[UCHAR_MAX + 1];
+    char others[UCHAR_MAX + 1];
+    int numberOfOthers;
+    void (*indexCells)(Row *row, const struct delimiters *delimiters, int start, int end);
+} Delimiters;
+/**
+ * @typedef Type of row selection function (resolved while parsing arguments)
+ */
+typedef enum selectionType {
+    ALL_ROWS,
+    ROWS,
+    BEGINS_WITH,
+    CONTAINS
+} SelectionType;
+/**
+ * @typedef Type of program defined function (resolved while parsing arguments)
+ */
+typedef enum functionType {
+    NO_FUNCTION,
+    AROW,
+    IROW,
+    DROW,
+    DROWS,
+    ICOL,
+    ACOL,
+    DCOL,
+    DCOLS,
+    CSET,
+    TOLOWER,
+    TOUPPER,
+    ROUND,
+    INT,
+    COPY,
+    SWAP,
+    MOVE
+} FunctionType;
+/**
+ * @typedef Definition of function usable in program arguments
  * @field name Name of the function
- * @field params Parameters' values required by function
- * @field strParams String parameters' values required by function
+ * @field numberOfParams Number of parameters required by function
+ * @field tableEditing Is it table editing function? (otherwise it's data processing function)
+ */
+typedef struct functionDefinition {
+    char *name;
+    int numberOfParams;
+    bool tableEditing;
+} FunctionDefinition;
+/**
+ * @typedef Program defined function for row selection
+ * @field type Type of the function (ALL_ROWS if selection isn't used)
+ * @field params Numeric parameters' values required by function (rows interval or column number and size of the value)
+ * @field value String parameter's value required by function (it points to program arguments)
  */
 typedef struct selectFunction {
-    char name[11];
+    SelectionType type;
     int params[2];
-    char strParams[2][MAX_CELL_SIZE];
+    const char *value;
 } SelectFunction;
 /**
- * @typedef Program defined function
- * @field name Name of the function
- * @field params Parameters' values required by function
- * @field strParams String parameters' values required by function
- * @field from The first selected row (NO_SELECTION if selection not active)
- * @field to The last selected row (LAST_ROW_NUMBER if the end of file)
+ * @typedef Program defined function (numeric parameters are together with type, so they share one cache line)
+ * @field type Type of the function (NO_FUNCTION marks the end of functions array)
+ * @field params Numeric parameters' values required by function (functions have 2 parameters at most; optional count
+ *        of new rows of irow and arow is the last one)
+ * @field value String parameter's value required by function (the second parameter of cset; it points to program
+ *        arguments)
+ * @field selectFunction Row selection for the function
  */
 typedef struct function {
-    char name[8];
-    int params[4];
-    char strParams[4][MAX_CELL_SIZE];
+    FunctionType type;
+    int params[2];
+    const char *value;
     SelectFunction selectFunction;
 } Function;
+/**
+ * @typedef Continuous part of an output row
+ * @field first First input column of the part (NEW_COLUMN for a new empty column)
+ * @field last Last input column of the part (columns between first and last are written as they are)
+ */
+typedef struct columnSpan {
+    int first;
+    int last;
+} ColumnSpan;
+/**
+ * @typedef RowInsertion New rows inserted before an input row (by all irow functions inserting them)
+ * @field row Number of the input row
+ * @field count Number of new rows inserted before it
+ */
+typedef struct rowInsertion {
+    int row;
+    long long count;
+} RowInsertion;
+/**
+ * @typedef Layout of output rows after applying all column editing functions (it's prepared by the first row)
+ * @field spans Parts of output rows in order (separated by delimiters)
+ * @field numberOfSpans Number of the parts
+ * @field numberOfColumns Number of columns in output rows (and new rows)
+ * @field inputNumOfCols Number of columns in each input row
+ * @field newLine Must output rows end with \n? (deleting columns ensures it)
+ * @field rearranged Do output rows differ from input rows?
+ * @field newRow Template of new rows (numberOfColumns - 1 delimiters and \n), so they're written as one block
+ * @field newRowSize Size of the template
+ * @field insertions Insertions of new rows sorted by numbers of input rows
+ * @field numberOfInsertions Number of the insertions
+ */
+typedef struct tableLayout {
+    ColumnSpan *spans;
+    int numberOfSpans;
+    int numberOfColumns;
+    int inputNumOfCols;
+    bool newLine;
+    bool rearranged;
+    char *newRow;
+    int newRowSize;
+    RowInsertion *insertions;
+    int numberOfInsertions;
+} TableLayout;
+/**
+ * @typedef Plain decimal number found in a cell (its parts point to the cell)
+ * @field negative Does the number start with '-'?
+ * @field integerPart Digits before decimal point
+ * @field integerSize Number of digits before decimal point
+ * @field decimalPart Digits after decimal point
+ * @field decimalSize Number of digits after decimal point
+ */
+typedef struct decimalNumber {
+    bool negative;
+    const char *integerPart;
+    int integerSize;
+    const char *decimalPart;
+    int decimalSize;
+} DecimalNumber;
+/**
+ * @typedef StatsCounterType Measured stages of processing (every function has its own counter after FUNCTION_COUNTER)
+ */
+typedef enum statsCounterType {
+    INPUT_COUNTER,
+    DELIMITERS_COUNTER,
+    VERIFICATION_COUNTER,
+    SELECTION_COUNTER,
+    OUTPUT_COUNTER,
+    FUNCTION_COUNTER,
+    NUMBER_OF_COUNTERS = FUNCTION_COUNTER + MAX_FUNCTIONS
+} StatsCounterType;
+/**
+ * @typedef Counter of a stage of processing
+ * @field calls Number of calls of the stage
+ * @field sampledCalls Number of calls with measured time
+ * @field measurements Number of measurements of time (calls of a batch of rows are measured at once)
+ * @field time Time of the measured calls (in nanoseconds)
+ */
+typedef struct statsCounter {
+    long long calls;
+    long long sampledCalls;
+    long long measurements;
+    long long time;
+} StatsCounter;
+/**
+ * @typedef Statistics of processing (--stats option)
+ * @field counters Counters of stages (see StatsCounterType)
+ * @field bytesIn Number of bytes of input rows
+ * @field rowsSelected Number of rows accepted by row selection
+ * @field rowsDeleted Number of deleted rows
+ * @field rowsInserted Number of new rows
+ * @field maxRowSize Size of the biggest row
+ * @field maxCellSize Size of the biggest cell (of indexed rows)
+ */
+typedef struct stats {
+    StatsCounter counters[NUMBER_OF_COUNTERS];
+    long long bytesIn;
+    long long rowsSelected;
+    long long rowsDeleted;
+    long long rowsInserted;
+    int maxRowSize;
+    int maxCellSize;
+} Stats;
+/**
+ * @typedef Branch Functions applied to the shared input rows with their own output (--tee option)
+ * @field path Path of the output file (NULL for standard output)
+ * @field functions Parsed and verified functions of the branch
+ * @field layout Layout of branch's output rows (it's prepared by the first row of the table)
+ * @field output Output of the branch
+ */
+typedef struct branch {
+    const char *path;
+    Function functions[MAX_FUNCTIONS + 1];
+    TableLayout layout;
+    Output *output;
+} Branch;
+/**
+ * @typedef Chunk Part of input (whole rows) processed independently of other parts
+ * @field buffer Chunk's own buffer (data are copied there if the input isn't mapped)
+ * @field capacity Size of the buffer
+ * @field input Rows of the chunk (as an input with all data in the buffer)
+ * @field firstRowNumber Number of the first row of the chunk
+ * @field numberOfRows Number of rows of the chunk (0 if they haven't been counted yet, see countChunkRows())
+ * @field output Processed rows (collected in memory)
+ * @field err Result of the processing
+ * @field processed Has the chunk been already processed?
+ * @field stats Statistics of the chunk's processing (they're added to the table's ones when the chunk is written)
+ */
+typedef struct chunk {
+    char *buffer;
+    size_t capacity;
+    Input input;
+    int firstRowNumber;
+    int numberOfRows;
+    Output output;
+    ErrorInfo err;
+    bool processed;
+    Stats stats;
+} Chunk;
+/**
+ * @typedef ParallelTable Table processed by more threads at once (state shared by all threads)
+ * @field functions Parsed and verified functions to apply
+ * @field delimiters Used delimiters
+ * @field layout Layout of output rows (it's set by the first chunk, before threads start)
+ * @field stats Statistics of processing (NULL if they aren't collected)
+ * @field chunks Ring of chunks in processing
+ * @field numberOfChunks Size of the ring
+ * @field loaded Number of chunks loaded so far (chunk N is in chunks[N % numberOfChunks])
+ * @field taken Number of chunks taken by threads for processing so far
+ * @field stop Should threads stop? (all chunks have been written or an error occurred)
+ * @field lock Lock for the shared state
+ * @field chunkLoaded Signal for threads waiting for a chunk to process
+ * @field chunkProcessed Signal for writing of processed chunks
+ */
+typedef struct parallelTable {
+    const Function *functions;
+    const Delimiters *delimiters;
+    TableLayout layout;
+    Stats *stats;
+    Chunk *chunks;
+    int numberOfChunks;
+    int loaded;
+    int taken;
+    bool stop;
+    pthread_mutex_t lock;
+    pthread_cond_t chunkLoaded;
+    pthread_cond_t chunkProcessed;
+} ParallelTable;
+/**
+ * @typedef PipelineTable Table processed by stages in their own threads (loading, processing and writing of chunks)
+ * @field functions Parsed and verified functions to apply
+ * @field delimiters Used delimiters
+ * @field layout Layout of output rows (it's used by the processing stage only)
+ * @field stats Statistics of processing (NULL if they aren't collected)
+ * @field input Input with table's rows (it's used by the loading stage only)
+ * @field numberOfRows Number of loaded rows (it's set by the loading stage when it finishes)
+ * @field chunks Ring of chunks in processing
+ * @field numberOfChunks Size of the ring
+ * @field loaded Number of chunks loaded so far (chunk N is in chunks[N % numberOfChunks])
+ * @field processed Number of chunks processed so far
+ * @field written Number of chunks written so far (their places in the ring can be reused)
+ * @field loadingFinished Has the loading stage finished? (no other chunk will be loaded)
+ * @field processingFinished Has the processing stage finished? (no other chunk will be processed)
+ * @field stop Should stages stop? (the writing stage has finished)
+ * @field waiting Number of stages waiting for the lock (only they must be woken up)
+ * @field lock Lock for waiting of stages (counters are changed without it)
+ * @field progress Signal for waiting stages (some counter has changed)
+ */
+typedef struct pipelineTable {
+    const Function *functions;
+    const Delimiters *delimiters;
+    TableLayout layout;
+    Stats *stats;
+    Input *input;
+    int numberOfRows;
+    Chunk chunks[PIPELINE_CHUNKS];
+    int numberOfChunks;
+    int loaded;
+    int processed;
+    int written;
+    bool loadingFinished;
+    bool processingFinished;
+    bool stop;
+    int waiting;
+    pthread_mutex_t lock;
+    pthread_cond_t progress;
+} PipelineTable;
+/**
+ * @typedef ValidationPart Part of mapped input validated by one thread (it starts and ends at a row boundary)
+ * @field data Data of the part
+ * @field size Size of the data
+ * @field delimiters Used delimiters
+ * @field numberOfCells Number of cells of the part's first row (0 for a part without rows)
+ * @field valid Do all rows of the part have the same number of cells?
+ */
+typedef struct validationPart {
+    const char *data;
+    size_t size;
+    const Delimiters *delimiters;
+    int numberOfCells;
+    bool valid;
+} ValidationPart;
+/**
+ * @typedef CellSlice Cell of a row gathered into column vector of a batch
+ * @field value Value of the cell (it points to row's data)
+ * @field size Size of the value
+ * @field row Index of the row in the batch
+ */
+typedef struct cellSlice {
+    char *value;
+    int size;
+    int row;
+} CellSlice;
+/**
+ * @typedef Batch Rows processed by data processing function at once (function is applied to a whole column of rows)
+ * @field rows Loaded rows (they're views into mapped input, so they stay valid until the next batch is loaded)
+ * @field indexed Bitmap of rows with indexed cells (other rows are rejected by rows selection, they're written as they
+ *        are)
+ * @field selected Bitmap of rows accepted by function's selection
+ * @field column Column vector (cells of one column of selected rows in the order of rows)
+ * @field columnSize Number of cells in the column vector
+ * @field results Results of the function for cells of the column vector (see applyBatchNumberFunction())
+ * @field resultSizes Sizes of the results (negative if the result must be computed by the row's function)
+ * @field arena Memory of all rows of the batch
+ */
+typedef struct batch {
+    Row rows[BATCH_SIZE];
+    unsigned long long indexed[BATCH_SIZE / 64];
+    unsigned long long selected[BATCH_SIZE / 64];
+    CellSlice column[BATCH_SIZE];
+    int columnSize;
+    char results[BATCH_SIZE][MAX_EXACT_RESULT_SIZE];
+    int resultSizes[BATCH_SIZE];
+    Arena arena;
+} Batch;
+
+/**
+ * @var functionDefinitions Definitions of all functions (indexed by FunctionType)
+ */
+const FunctionDefinition functionDefinitions[] = {
+        [NO_FUNCTION] = {NULL, 0, false},
+        [AROW] = {"arow", 0, true},
+        [IROW] = {"irow", 1, true},
+        [DROW] = {"drow", 1, true},
+        [DROWS] = {"drows", 2, true},
+        [ICOL] = {"icol", 1, true},
+        [ACOL] = {"acol", 0, true},
+        [DCOL] = {"dcol", 1, true},
+        [DCOLS] = {"dcols", 2, true},
+        [CSET] = {"cset", 2, false},
+        [TOLOWER] = {"tolower", 1, false},
+        [TOUPPER] = {"toupper", 1, false},
+        [ROUND] = {"round", 1, false},
+        [INT] = {"int", 1, false},
+        [COPY] = {"copy", 2, false},
+        [SWAP] = {"swap", 2, false},
+        [MOVE] = {"move", 2, false}
+};
 
 // Input/Output functions
-bool loadRow(Row *row, char *preloadedData);
-void writeProcessedRow(const Row *row);
-void writeNewRow(char delimiter, int numberOfColumns);
+bool openInput(Input *input, int fd);
+bool openFileInput(Input *input, const char *path);
+void closeInput(Input *input);
+bool fillInput(Input *input, size_t *keep);
+bool loadRow(Row *row, Input *input);
+bool openOutput(Output *output, int fd, bool lineBuffered);
+void closeOutput(Output *output);
+bool flushOutput(Output *output);
+bool finishOutput(Output *output);
+void writeOutputData(Output *output, const char *data, size_t size);
+bool reserveOutput(Output *output, int size);
+void writeOutput(Output *output, const char *data, int size);
+void writeProcessedRow(Output *output, const Row *row);
+void writeOverriddenRow(Output *output, const Row *row);
+void writeRearrangedRow(Output *output, const Row *row, const TableLayout *layout, char delimiter);
+void writeNewRows(Output *output, const TableLayout *layout, long long count);
 void writeErrorMessage(const char *message);
 // Main control and processing
-char unifyRowDelimiters(Row *row, const char **delimiters);
-ErrorInfo verifyRow(const Row *row, char delimiter);
+ErrorInfo processTable(Input *input, Output *output, const Function *functions, const Delimiters *delimiters,
+                       Stats *stats);
+ErrorInfo processRows(Input *input, Output *output, const Function *functions, const Delimiters *delimiters, Row *row,
+                      TableLayout *layout, Stats *stats);
+ErrorInfo applyFunctions(Row *row, const Function *functions, const TableLayout *layout, bool selected, char delimiter,
+                         Output *output, Stats *stats, bool sampled);
+ErrorInfo finishTable(Output *output, const Function *functions, const TableLayout *layout, int numberOfRows,
+                      Stats *stats);
+void prepareDelimiters(Delimiters *delimiters, const char *string);
+ErrorInfo verifyRow(Row *row, const Delimiters *delimiters);
 ErrorInfo parseInputArguments(Function *functions, const InputArguments *args);
-ErrorInfo applyTableEditingFunction(Row *row, Function function, char delimiter, int *numberOfColumns);
-ErrorInfo applyDataProcessingFunction(Row *row, Function function, char delimiter, int numberOfColumns);
-void applyAppendRowFunctions(InputArguments *args, char delimiter, int numberOfColumns);
-ErrorInfo acceptsSelection(bool *result, Row *row, SelectFunction *selection, char delimiter, int numberOfColumns);
+ErrorInfo verifyFunctions(const Function *functions);
+ErrorInfo prepareTableLayout(TableLayout *layout, const Function *functions, int inputNumOfCols, char delimiter);
+ErrorInfo prepareRowInsertions(TableLayout *layout, const Function *functions);
+long long getInsertedRows(const TableLayout *layout, int number);
+void freeTableLayout(TableLayout *layout);
+void applyTableEditingFunction(Row *row, const Function *function);
+ErrorInfo applyDataProcessingFunction(Row *row, const Function *function, char delimiter);
+void applyAppendRowFunctions(Output *output, const Function *functions, const TableLayout *layout);
+bool acceptsSelection(const Row *row, const SelectFunction *selection);
+const SelectFunction *getRowsSelection(const Function *functions);
+bool needsLastRow(const Function *functions);
+// Parallel processing
+ErrorInfo processTableInParallel(Input *input, Output *output, const Function *functions,
+                                 const Delimiters *delimiters, int numberOfThreads, Stats *stats);
+bool loadChunk(Chunk *chunk, Input *input, int firstRowNumber);
+int countChunkRows(const Chunk *chunk);
+void processChunk(Chunk *chunk, const Function *functions, const Delimiters *delimiters, TableLayout *layout,
+                  Stats *stats);
+void *processChunks(void *parallelTable);
+ErrorInfo processTableInPipeline(Input *input, Output *output, const Function *functions,
+                                 const Delimiters *delimiters, Stats *stats);
+void *loadPipelineChunks(void *pipelineTable);
+void *processPipelineChunks(void *pipelineTable);
+bool waitForChunks(PipelineTable *table, const int *counter, int count, const bool *finished);
+void advanceStage(PipelineTable *table, int *counter, int count);
+void finishStage(PipelineTable *table, bool *finished);
+ErrorInfo validateTable(Input *input, const Delimiters *delimiters);
+void *validatePart(void *validationPart);
+void validatePartScalar(ValidationPart *part, size_t start, int cells);
+#ifdef X86_SIMD
+void validatePartSse2(ValidationPart *part);
+#endif
+bool addPartRow(ValidationPart *part, int cells);
+// Row index
+ErrorInfo openRowIndex(RowIndex *index, Input *input, const Delimiters *delimiters, const char *path);
+bool prepareIndexHeader(IndexHeader *header, const Input *input, const Delimiters *delimiters);
+bool loadRowIndex(RowIndex *index, const IndexHeader *header, const char *path);
+ErrorInfo buildRowIndex(RowIndex *index, Input *input, const Delimiters *delimiters);
+bool saveRowIndex(const RowIndex *index, IndexHeader *header, const char *path);
+void freeRowIndex(RowIndex *index);
+unsigned long long getIndexChecksum(const RowIndex *index);
+size_t getRowOffset(const RowIndex *index, const Input *input, int number);
+int getNextAffectedRow(const Function *functions, const RowIndex *index, int number);
+void copyUnaffectedRows(Input *input, Output *output, Row *row, const Function *functions);
+// Branch processing
+ErrorInfo parseBranches(Branch *branches, int *numberOfBranches, const InputArguments *args);
+bool openBranchOutputs(Branch *branches, int numberOfBranches);
+bool closeBranchOutputs(Branch *branches, int numberOfBranches);
+ErrorInfo processBranches(Input *input, Branch *branches, int numberOfBranches, const Delimiters *delimiters);
+void prepareRowView(Row *view, const Row *row);
+// Compression
+bool isCompressedPath(const char *path);
+bool openDecompressor(Input *input);
+void closeDecompressor(Input *input);
+size_t readDecompressed(Input *input, char *buffer, size_t size);
+bool openCompressor(Output *output);
+void closeCompressor(Output *output);
+void compressOutput(Output *output, bool finish);
+#ifdef ENABLE_ZLIB
+void freeDecompressor(Decompressor *decompressor);
+void *decompressInput(void *data);
+size_t decompressBlock(Decompressor *decompressor, char *block, bool *finished);
+#endif
+// Batch processing
+bool isBatchable(const Input *input, const Function *functions);
+ErrorInfo processBatches(Input *input, Output *output, const Function *functions, const Delimiters *delimiters,
+                         Row *row, TableLayout *layout, Stats *stats);
+int loadBatch(Batch *batch, Input *input, Row *row);
+ErrorInfo verifyBatch(Batch *batch, int *limit, const Input *input, const Function *functions,
+                      const Delimiters *delimiters, TableLayout *layout, Stats *stats);
+int selectBatchRows(Batch *batch, int limit, const SelectFunction *selection, bool resolved, Stats *stats);
+ErrorInfo applyBatchFunction(Batch *batch, int *limit, const Function *function, char delimiter);
+ErrorInfo applyBatchCaseFunction(Batch *batch, int *limit, const Function *function);
+ErrorInfo applyBatchNumberFunction(Batch *batch, int *limit, const Function *function);
+void gatherColumn(Batch *batch, int limit, int column);
+void writeBatch(Output *output, const Batch *batch, int limit, const TableLayout *layout, char delimiter);
+int nextBatchRow(const unsigned long long *bitmap, int row, int limit);
+// Statistics
+bool isSampled(const Stats *stats);
+long long startMeasure(bool sampled);
+void endMeasure(Stats *stats, int counter, long long start, bool sampled);
+void endBatchMeasure(Stats *stats, int counter, long long start, int calls);
+void addRowStats(Stats *stats, const Row *row, bool indexed);
+void mergeStats(Stats *target, const Stats *source);
+void writeStats(const Stats *stats, const Function *functions, long long bytesOut);
+long long getTime(void);
 // Table editing functions
-ErrorInfo drows(int from, int to, Row *row);
-ErrorInfo icol(int column, Row *row, char delimiter, int *numberOfColumns);
-ErrorInfo acol(Row *row, char delimiter, int *numberOfColumns);
-ErrorInfo dcols(int from, int to, Row *row, char delimiter);
+void drows(int from, int to, Row *row);
+void dcols(int from, int to, Row *row);
 // Data processing functions
-ErrorInfo cset(int column, char *value, Row *row, char delimiter, int numberOfColumns);
-void changeColumnCase(bool newCase, int column, Row *row, char delimiter, int numberOfColumns);
-ErrorInfo roundColumnValue(int column, Row *row, char delimiter, int numberOfColumns);
-ErrorInfo removeColumnDecimalPart(int column, Row *row, char delimiter, int numberOfColumns);
-void copy(int from, int to, Row *row, char delimiter, int numberOfColumns);
-void swap(int first, int second, Row *row, char delimiter, int numberOfColumns);
-void move(int column, int beforeColumn, Row *row, char delimiter, int numberOfColumns);
+ErrorInfo cset(int column, const char *value, Row *row);
+void changeColumnCase(bool newCase, int from, int to, Row *row);
+ErrorInfo roundColumnValue(int column, Row *row);
+ErrorInfo removeColumnDecimalPart(int column, Row *row);
+void copy(int from, int to, Row *row);
+void swap(int first, int second, Row *row);
+void move(int column, int beforeColumn, Row *row, char delimiter);
 // Help functions
-bool isDelimiter(char c, const char **delimiters);
-bool checkCellsSize(const Row *row, char delimiter);
-int countColumns(Row *row, char delimiter);
+void indexRowCells(Row *row, const Delimiters *delimiters);
+int countRowCells(Row *row, const Delimiters *delimiters);
+void indexCellsScalar(Row *row, const Delimiters *delimiters, int start, int end);
+void indexCellsSingle(Row *row, const Delimiters *delimiters, int start, int end);
+#ifdef X86_SIMD
+void indexCellsSse2(Row *row, const Delimiters *delimiters, int start, int end);
+void indexCellsAvx2(Row *row, const Delimiters *delimiters, int start, int end);
+void indexCellsSingleSse2(Row *row, const Delimiters *delimiters, int start, int end);
+void indexCellsSingleAvx2(Row *row, const Delimiters *delimiters, int start, int end);
+#endif
+#ifdef NEON_SIMD
+void indexCellsNeon(Row *row, const Delimiters *delimiters, int start, int end);
+#endif
+void addCellStarts(Row *row, unsigned int delimiterMask, int offset);
+int getCellStart(const Row *row, int column);
+int getCellSize(const Row *row, int column);
+void convertCase(char *value, int size, char start);
 ErrorInfo getFunctionFromArgs(Function *function, const InputArguments *args, int *position);
+ErrorInfo getSelectFunctionFromArgs(SelectFunction *selection, const InputArguments *args, int *position);
 int toRowColNum(char *value, bool specialAllowed);
-void getColumnValue(char *value, const Row *row, int columnNumber, char delimiter, int numberOfColumns);
-void setColumnValue(const char *value, Row *row, int columnNumber, char delimiter, int numberOfColumns);
+bool cellContains(const Row *row, int column, const char *value, int valueSize);
+#ifdef X86_SIMD
+bool findValueSse2(const char *cell, int cellSize, const char *value, int valueSize, int *checked);
+#endif
+char *getColumnValue(Row *row, int columnNumber);
+void setColumnValue(const char *value, Row *row, int columnNumber);
+bool overrideCell(Row *row, int columnNumber, const char *value, int valueSize);
+void applyCellOverrides(Row *row);
+void replaceRowData(Row *row, int start, int end, const char *value, int valueSize);
+bool moveRowToStorage(Row *row, int size);
+bool reserveRowCells(Row *row, int numberOfCells);
+void *allocateRowMemory(Row *row, size_t size);
+void *allocateFromArena(Arena *arena, size_t size);
+void resetArena(Arena *arena);
+void freeArena(Arena *arena);
 bool isValidNumber(char *number);
+bool scanDecimalNumber(const char *value, int size, DecimalNumber *number);
+int formatRoundedNumber(const DecimalNumber *number, char *result);
+int formatIntegerPart(const DecimalNumber *number, char *result);
 
 /**
  * Main function
@@ -163,743 +935,3947 @@ int main(int argc, char **argv) {
     // The first argument is skipped (program path)
     InputArguments args = {argv, argc, 1};
 
-    // Delimiters
-    char **delimiters;
-    // EDIT: Forgotten check of -d argument existence
-    if (argc >= 3 && streq(args.data[args.skipped], "-d")) {
-        delimiters = &args.data[args.skipped + 1];
+    // Options (they must be before functions and each of them except --stats, --pipeline, --validate-first and --gzip
+    // has a value)
+    const char *delimitersString = DEFAULT_DELIMITER;
+    char *inputFile = NULL; // Standard input is used by default
+    char *indexFile = NULL; // Rows are indexed only on demand
+    int numberOfThreads = 1;
+    bool collectStats = false;
+    bool pipelined = false;
+    bool validateFirst = false;
+    bool gzipped = false; // Are standard input and output compressed?
+    while (args.skipped < args.size) {
+        if (streq(args.data[args.skipped], "--stats")) {
+            collectStats = true;
+            args.skipped++;
+
+            continue;
+        } else if (streq(args.data[args.skipped], "--pipeline")) {
+            pipelined = true;
+            args.skipped++;
+
+            continue;
+        } else if (streq(args.data[args.skipped], "--validate-first")) {
+            validateFirst = true;
+            args.skipped++;
+
+            continue;
+        } else if (streq(args.data[args.skipped], "--gzip")) {
+            gzipped = true;
+            args.skipped++;
+
+            continue;
+        }
+
+        if (args.skipped + 1 >= args.size) {
+            break;
+        } else if (streq(args.data[args.skipped], "-d")) {
+            delimitersString = args.data[args.skipped + 1];
+        } else if (streq(args.data[args.skipped], "-f")) {
+            inputFile = args.data[args.skipped + 1];
+        } else if (streq(args.data[args.skipped], "--index")) {
+            indexFile = args.data[args.skipped + 1];
+        } else if (streq(args.data[args.skipped], "-j")) {
+            numberOfThreads = toRowColNum(args.data[args.skipped + 1], false);
+            if (numberOfThreads == INVALID_NUMBER || numberOfThreads > MAX_THREADS) {
+                writeErrorMessage("Neplatny pocet vlaken.");
+
+                return EXIT_FAILURE;
+            }
+        } else {
+            break;
+        }
+
         args.skipped += 2;
-    } else {
-        const char *DELIMITER = DEFAULT_DELIMITER;
-        delimiters = (char **) &DELIMITER;
     }
 
-    /* ROW PARSING */
+    // Functions are the same for all rows, so they're parsed and verified only once before loading any input
     ErrorInfo err;
-    Row row = {.size = 0, .number = 0, .last = false};
-    char delimiter;
-    int numberOfColumns;
-    int inputNumOfCols; // Number of columns in input table
-    char preloadedData[MAX_ROW_SIZE];
-    while (loadRow(&row, preloadedData) == true) {
-        // Delimiter processing
-        delimiter = unifyRowDelimiters(&row, (const char **) delimiters);
+    Branch branches[MAX_BRANCHES];
+    int numberOfBranches;
+    if ((err = parseBranches(branches, &numberOfBranches, &args)).error == true) {
+        writeErrorMessage(err.message);
+
+        return EXIT_FAILURE;
+    }
+    const Function *functions = branches[0].functions;
 
-        // Validation
-        if ((err = verifyRow(&row, delimiter)).error == true) {
-            writeErrorMessage(err.message);
+    // Branches share one pass over rows in the main thread (see processBranches())
+    if (numberOfBranches > 1 && (numberOfThreads > 1 || pipelined == true || collectStats == true)) {
+        writeErrorMessage("Volbu --tee nelze kombinovat s -j, --pipeline ani --stats.");
 
-            return EXIT_FAILURE;
-        }
+        return EXIT_FAILURE;
+    }
 
-        // Arguments processing
-        Function functions[MAX_FUNCTIONS];
-        if ((err = parseInputArguments(functions, &args)).error == true) {
-            writeErrorMessage(err.message);
+    // Compressed files are recognized by their suffix
+    bool compressed = gzipped == true || (inputFile != NULL && isCompressedPath(inputFile) == true);
+    for (int i = 1; i < numberOfBranches; i++) {
+        compressed = compressed == true || isCompressedPath(branches[i].path) == true;
+    }
+    if (compressed == true && GZIP_SUPPORTED == false) {
+        writeErrorMessage("Komprimovany vstup ani vystup nejsou podporovany.");
 
-            return EXIT_FAILURE;
-        }
+        return EXIT_FAILURE;
+    }
 
-        // Data processing
-        if(row.number == 1) {
-            inputNumOfCols = numberOfColumns = countColumns(&row, delimiter);
-        } else if (countColumns(&row, delimiter) != inputNumOfCols) {
-            writeErrorMessage("Kazdy radek musi mit stejny pocet sloupcu.");
+    /* ROW PARSING */
+    Input input;
+    if (inputFile != NULL) {
+        if (openFileInput(&input, inputFile) == false) {
+            writeErrorMessage("Nepodarilo se otevrit vstupni soubor.");
 
             return EXIT_FAILURE;
         }
+    } else if (openInput(&input, STDIN_FILENO) == false) {
+        writeErrorMessage("Nedostatek pameti pro nacitani vstupu.");
 
-        int i = 0;
-        bool tableChanged = false;
-        bool dataChanged = false;
-        while (functions[i].name[0] != '\0') {
-            SelectFunction selection = functions[i].selectFunction;
+        return EXIT_FAILURE;
+    }
 
-            // Table editing functions
-            if ((err = applyTableEditingFunction(&row, functions[i], delimiter, &numberOfColumns)).error == true) {
-                writeErrorMessage(err.message);
+    // Compressed standard input is decompressed in its own thread (see decompressInput())
+    if (inputFile == NULL && gzipped == true && openDecompressor(&input) == false) {
+        writeErrorMessage("Nedostatek pameti pro nacitani vstupu.");
+        closeInput(&input);
 
-                return EXIT_FAILURE;
-            } else if (err.message == NULL) {
-                // Selections on table editing functions are forbidden
-                if (selection.name[0] != '\0') {
-                    writeErrorMessage("Funkce pro vyber radku neni mozne pouzit na funkce menici tabulku.");
+        return EXIT_FAILURE;
+    }
 
-                    return EXIT_FAILURE;
-                }
+    // Data after a row are read in advance only if the last row is selected (reading would wait for them otherwise)
+    input.lookahead = false;
+    for (int i = 0; i < numberOfBranches; i++) {
+        input.lookahead = input.lookahead == true || needsLastRow(branches[i].functions);
+    }
 
-                // Does not make sense to continue with processing if the row was marked as deleted
-                if (row.deleted == true) {
-                    break;
-                }
+    // Compressed output isn't written after every row (compression of single rows would be useless)
+    Output output;
+    if (openOutput(&output, STDOUT_FILENO, gzipped == false && isatty(STDOUT_FILENO)) == false ||
+        (gzipped == true && openCompressor(&output) == false)) {
+        writeErrorMessage("Nedostatek pameti pro zapis vystupu.");
+        closeInput(&input);
+        closeOutput(&output);
 
-                tableChanged = true;
-                i++;
-                continue;
-            }
+        return EXIT_FAILURE;
+    }
 
-            if (dataChanged == true) {
-                writeErrorMessage("Je mozne pouzit pouze jednu funkci pro zpracovani dat.");
+    Delimiters delimiters;
+    prepareDelimiters(&delimiters, delimitersString);
 
-                return EXIT_FAILURE;
-            }
+    // Only mapped input file can be read twice (other inputs are validated row by row while they're processed)
+    if (validateFirst == true && input.mapped == true && (err = validateTable(&input, &delimiters)).error == true) {
+        writeErrorMessage(err.message);
+        closeInput(&input);
+        closeOutput(&output);
 
-            // Row selection (don't modify some rows with actual function)
-            bool accepts;
-            if ((err = acceptsSelection(&accepts, &row, &selection, delimiter, numberOfColumns)).error == true) {
-                writeErrorMessage(err.message);
+        return EXIT_FAILURE;
+    }
 
-                return EXIT_FAILURE;
-            }
+    // Offsets of rows are stable only in mapped input file (the index is reused by later runs with the same file)
+    RowIndex index = {NULL};
+    if (indexFile != NULL && input.mapped == true &&
+        (err = openRowIndex(&index, &input, &delimiters, indexFile)).error == true) {
+        writeErrorMessage(err.message);
+        closeInput(&input);
+        closeOutput(&output);
 
-            // Skip applying the function on this row
-            if (accepts == false) {
-                i++;
-                continue;
-            }
+        return EXIT_FAILURE;
+    }
 
-            // Data processing functions
-            if ((err = applyDataProcessingFunction(&row, functions[i], delimiter, numberOfColumns)).error == true) {
-                writeErrorMessage(err.message);
+    // Statistics are collected only on demand (they're quite big and measuring is not free)
+    Stats *stats = NULL;
+    if (collectStats == true && (stats = calloc(1, sizeof(Stats))) == NULL) {
+        writeErrorMessage("Nedostatek pameti pro statistiky.");
+        freeRowIndex(&index);
+        closeInput(&input);
+        closeOutput(&output);
 
-                return EXIT_FAILURE;
-            } else if (err.message == NULL) {
-                dataChanged = true;
-            }
+        return EXIT_FAILURE;
+    }
 
-            i++;
-        }
+    // Outputs of branches are created only when the input is ready
+    branches[0].output = &output;
+    if (openBranchOutputs(branches, numberOfBranches) == false) {
+        writeErrorMessage("Nepodarilo se otevrit vystupni soubor.");
+        freeRowIndex(&index);
+        closeInput(&input);
+        closeOutput(&output);
 
-        if (tableChanged && dataChanged) {
-            writeErrorMessage("Je mozne pouzit pouze funkce pro zmenu tabulky nebo pouze pro zpracovani dat.");
+        return EXIT_FAILURE;
+    }
 
-            return EXIT_FAILURE;
-        }
+    // Parallel processing has its own threads for rows, so loading and writing already overlap with processing there
+    if (numberOfBranches > 1) {
+        err = processBranches(&input, branches, numberOfBranches, &delimiters);
+    } else if (numberOfThreads > 1) {
+        err = processTableInParallel(&input, &output, functions, &delimiters, numberOfThreads, stats);
+    } else if (pipelined == true) {
+        err = processTableInPipeline(&input, &output, functions, &delimiters, stats);
+    } else {
+        err = processTable(&input, &output, functions, &delimiters, stats);
+    }
 
-        // Write output
-        if (row.deleted == false) {
-            writeProcessedRow(&row);
-        }
+    // Rows after corrupted compressed data are missing (it's the cause of other errors, too)
+    if (input.corrupted == true) {
+        err.error = true;
+        err.message = "Nepodarilo se rozbalit vstup.";
     }
 
-    // Empty input
-    if (row.number == 0) {
-        writeErrorMessage("Prazdny vstup neni povolen.");
+    // Rows processed before an error are written, too
+    bool written = finishOutput(&output);
+    written = closeBranchOutputs(branches, numberOfBranches) == true && written == true;
+    if (written == false && err.error == false) {
+        err.error = true;
+        err.message = "Nepodarilo se zapsat vystup.";
+    }
 
-        return EXIT_FAILURE;
+    if (stats != NULL) {
+        writeStats(stats, functions, output.written);
+        free(stats);
     }
 
-    // New content
-    applyAppendRowFunctions(&args, delimiter, numberOfColumns);
+    freeRowIndex(&index);
+    closeInput(&input);
+    closeOutput(&output);
+
+    if (err.error == true) {
+        writeErrorMessage(err.message);
+
+        return EXIT_FAILURE;
+    }
 
     return EXIT_SUCCESS;
 }
 
 /***********************************************************************************************Input/Output functions*/
 /**
- * Loads a new row from standard input
- * @param row Pointer to Row; it's required to set number and size fields
- * @param preloadedData Data preloaded in previous loadRow() call
- * @return Was it successful? If false, no other input is available.
+ * Prepares input for loading rows
+ * @param input Input to prepare
+ * @param fd File descriptor to read data from
+ * @return Was it successful? If false, there isn't enough memory for input buffer.
  */
-bool loadRow(Row *row, char *preloadedData) {
-    // Previous row was the last one
-    if (row->last) {
+bool openInput(Input *input, int fd) {
+    input->fd = fd;
+    input->capacity = INPUT_BLOCK_SIZE;
+    input->size = 0;
+    input->position = 0;
+    input->mapped = false;
+    input->readOnly = false;
+    input->partial = false;
+    input->failed = false;
+    input->lookahead = true;
+    input->numberOfColumns = 0;
+    input->index = NULL;
+    input->decompressor = NULL;
+    input->corrupted = false;
+
+    return (input->buffer = malloc(input->capacity)) != NULL;
+}
+
+/**
+ * Prepares input file for loading rows (regular files are mapped into memory, so rows are views into the file)
+ * @param input Input to prepare
+ * @param path Path to the input file (files with GZIP_SUFFIX are decompressed)
+ * @return Was it successful? If false, the file can't be opened (or there isn't enough memory).
+ */
+bool openFileInput(Input *input, const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
         return false;
     }
 
-    // First loading
-    if (row->number == 0) {
-        memset(preloadedData, '\0', row->size);
+    // Files with unknown size (pipes etc.), empty files (they can't be mapped) and compressed files are read in blocks
+    struct stat info;
+    bool compressed = isCompressedPath(path);
+    if (compressed == true || fstat(fd, &info) != 0 || S_ISREG(info.st_mode) == false || info.st_size == 0) {
+        if (openInput(input, fd) == false) {
+            close(fd);
 
-        // Try to load data for the first row; if unsuccessful return false
-        if (fgets(preloadedData, MAX_ROW_SIZE, stdin) == NULL) {
             return false;
         }
-    }
 
-    // Load data of the current row
-    memset(row->data, '\0', row->size);
-    memmove(row->data, preloadedData, strlen(preloadedData));
+        if (compressed == true && openDecompressor(input) == false) {
+            closeInput(input);
 
-    // Update structure with new data
-    row->size = (int)strlen(row->data);
-    row->number++;
-    row->deleted = false;
+            return false;
+        }
 
-    // Try to preload new data for next row; if unsuccessful set row as the last
-    if (fgets(preloadedData, MAX_ROW_SIZE, stdin) == NULL) {
-        row->last = true;
-    } else {
-        row->last = false;
+        return true;
+    }
+
+    void *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        close(fd);
+
+        return false;
     }
+    posix_madvise(data, info.st_size, POSIX_MADV_SEQUENTIAL);
+
+    input->fd = fd;
+    input->buffer = data;
+    input->capacity = input->size = info.st_size;
+    input->position = 0;
+    input->mapped = true;
+    input->readOnly = true;
+    input->partial = false;
+    input->failed = false;
+    input->lookahead = true;
+    input->numberOfColumns = 0;
+    input->index = NULL;
+    input->decompressor = NULL;
+    input->corrupted = false;
 
     return true;
 }
 
 /**
- * Writes already processed row to standard output
- * @param row Processed row
+ * Releases resources of the input
+ * @param input Input to close
  */
-void writeProcessedRow(const Row *row) {
-    printf("%s", row->data);
-}
+void closeInput(Input *input) {
+    // Decompressing thread reads from the file
+    closeDecompressor(input);
 
-/**
- * Writes new row to standard output
- * @param delimiter Column delimiter
- * @param numberOfColumns Number of columns of the new row
- */
-void writeNewRow(char delimiter, int numberOfColumns) {
-    for (int i = 0; i < numberOfColumns - 1; i++) {
-        putchar(delimiter);
+    if (input->mapped == true) {
+        munmap(input->buffer, input->size);
+    } else {
+        free(input->buffer);
     }
-    putchar('\n');
-}
+    input->buffer = NULL;
 
-/**
- * Writes error message to standard error output
- * @param message Error message
- */
-void writeErrorMessage(const char *message) {
-    fprintf(stderr, "sheet: %s", message);
+    if (input->fd != STDIN_FILENO) {
+        close(input->fd);
+    }
 }
 
-/******************************************************************************************Main control and processing*/
 /**
- * Unifies delimiters in provided row - all will be replaced with the first one
- * @param row Edited row
- * @param delimiters Used delimiters
- * @return Result delimiter
+ * Loads next block of data to input buffer
+ * @param input Input to load data to
+ * @param keep Position of the first byte in buffer that has to be kept (it's updated when data are moved)
+ * @return Was some data loaded? If false, no other input is available (or there isn't enough memory, see failed).
  */
-char unifyRowDelimiters(Row *row, const char **delimiters) {
-    char mainDelimiter = (*delimiters)[0];
-
-    for (int i = 0; i < row->size; i++) {
-        if (isDelimiter(row->data[i], delimiters) && (row->data[i] != mainDelimiter)) {
-            row->data[i] = mainDelimiter;
-        }
+bool fillInput(Input *input, size_t *keep) {
+    // Mapped file (or chunk) is whole in the buffer
+    if (input->mapped == true) {
+        return false;
     }
 
-    return mainDelimiter;
-}
+    // Data before the kept part aren't needed anymore, so the kept part is moved to the start of the buffer
+    if (*keep > 0) {
+        memmove(input->buffer, &input->buffer[*keep], input->size - *keep);
+        input->size -= *keep;
+        input->position -= *keep;
+        *keep = 0;
+    }
 
-/**
- * Verifies input conditions for row
- * @param row Row to be checked
- * @param delimiter Column delimiter
- * @return Is the row valid?
- */
-ErrorInfo verifyRow(const Row *row, char delimiter) {
-    ErrorInfo errorInfo = {false};
+    // Whole buffer is kept (it contains a part of very long row), so it must grow
+    if (input->size == input->capacity) {
+        char *buffer = realloc(input->buffer, input->capacity * 2);
+        if (buffer == NULL) {
+            input->failed = true;
 
-    // Check max row size
-    if (row->size > MAX_ROW_SIZE) {
-        errorInfo.error = true;
-        errorInfo.message = "Byla prekrocena maximalni velikost radku.";
+            return false;
+        }
 
-        return errorInfo;
+        input->buffer = buffer;
+        input->capacity *= 2;
     }
 
-    // Check cell size
-    if (checkCellsSize(row, delimiter) == false) {
-        errorInfo.error = true;
-        errorInfo.message = "Byla prekrocena maximalni velikost bunky.";
+    ssize_t loaded;
+    if (input->decompressor != NULL) {
+        loaded = (ssize_t)readDecompressed(input, &input->buffer[input->size], input->capacity - input->size);
+    } else {
+        do {
+            loaded = read(input->fd, &input->buffer[input->size], input->capacity - input->size);
+        } while (loaded < 0 && errno == EINTR);
+    }
 
-        return errorInfo;
+    if (loaded <= 0) {
+        return false;
     }
 
-    return errorInfo;
+    input->size += loaded;
+
+    return true;
 }
 
 /**
- * Parses arguments into functions (instances of Function data type)
- * @param functions Pointer to array fro saving parsed output
- * @param args Program input arguments
- * @return Error information
+ * Loads a new row from input (row's data are a view into input buffer, they aren't copied)
+ * @param row Pointer to Row; it's required to set number, last and arena fields (the arena is reset by the caller)
+ * @param input Input to load the row from
+ * @return Was it successful? If false, no other input is available.
  */
-ErrorInfo parseInputArguments(Function *functions, const InputArguments *args) {
-    ErrorInfo errorInfo = {false};
+bool loadRow(Row *row, Input *input) {
+    // Previous row was the last one
+    if (row->last) {
+        return false;
+    }
 
-    int funcIndex = 0;
-    for (int i = args->skipped; i < args->size; i++) {
-        Function function;
-        if ((errorInfo = getFunctionFromArgs(&function, args, &i)).error == true) {
-            return errorInfo;
+    // Find the end of the row (load more data if the row isn't whole in the buffer)
+    size_t start = input->position;
+    size_t size = 0; // Number of row's chars that have already been searched for \n
+    while (true) {
+        char *newLine = memchr(&input->buffer[start + size], '\n', input->size - start - size);
+        if (newLine != NULL) {
+            size = newLine - &input->buffer[start] + 1;
+            break;
         }
 
-        functions[funcIndex] = function;
-        funcIndex++;
+        // The end of input or the row continues in data that haven't been loaded yet
+        size = input->size - start;
+        if (fillInput(input, &start) == false) {
+            break;
+        }
     }
 
-    return errorInfo;
-}
-
-/**
- * Applies table editing function on provided row
- * @param row Input (raw) row
- * @param function Function to use
- * @param delimiters Column delimiter
- * @param numberOfColumns Number of column in each row
- * @return Error information
- */
-ErrorInfo applyTableEditingFunction(Row *row, Function function, char delimiter, int *numberOfColumns) {
-    ErrorInfo errorInfo = {false};
+    // Previous row was the last one (ended with \n) or the row can't be loaded whole
+    if (size == 0 || input->failed == true) {
+        return false;
+    }
 
-    // Column-operated functions are skipped if the row is set as deleted - it doesn't make sense to apply them
-    if (streq(function.name, "irow")) {
-        if (row->number == function.params[0]) {
-            writeNewRow(delimiter, *numberOfColumns);
-        }
+    input->position = start + size;
 
-        return errorInfo;
-    } else if (streq(function.name, "drow") || streq(function.name, "drows")) {
-        if (streq(function.name, "drow")) {
-            function.params[1] = function.params[0];
-        }
+    // Try to preload data for next row; if unsuccessful set row as the last (the last one of the whole input)
+    if (input->position == input->size && input->lookahead == true) {
+        fillInput(input, &start);
+    }
 
-        return drows(function.params[0], function.params[1], row);
-    } else if (streq(function.name, "icol")) {
-        return icol(function.params[0], row, delimiter, numberOfColumns);
-    } else if (streq(function.name, "acol")) {
-        return acol(row, delimiter, numberOfColumns);
-    } else if (streq(function.name, "dcol") || streq(function.name, "dcols")) {
-        if (streq(function.name, "dcol")) {
-            function.params[1] = function.params[0];
-        }
+    // Without preloading only the end of the whole input in the buffer is known (the last row stays unknown otherwise)
+    row->last = input->partial == false && input->position == input->size &&
+                (input->mapped == true || input->lookahead == true);
 
-        return dcols(function.params[0], function.params[1], row, delimiter);
-    }
+    // Update structure with new data (row's memory from the previous row can be reused)
+    row->data = &input->buffer[start];
+    row->size = (int)size;
+    row->readOnly = input->readOnly;
+    row->number++;
+    row->deleted = false;
 
-    errorInfo.message = "NO_FUNCTION_USED";
-    return errorInfo;
+    row->storage = NULL;
+    row->storageCapacity = 0;
+    row->cells = NULL;
+    row->cellsCapacity = 0;
+    row->numberOfOverrides = 0;
+
+    return true;
 }
 
 /**
- * Applies append row functions to output
- * @param args Program input arguments
- * @param delimiter Column delimiter
- * @param numberOfColumns Number of columns
+ * Prepares output for writing rows
+ * @param output Output to prepare
+ * @param fd File descriptor to write data to (negative for output collected in memory)
+ * @param lineBuffered Should be every row written immediately? (for interactive outputs)
+ * @return Was it successful? If false, there isn't enough memory for output buffer.
  */
-void applyAppendRowFunctions(InputArguments *args, char delimiter, int numberOfColumns) {
-    for (int i = args->skipped; i < args->size; i++) {
-        if (streq(args->data[i], "arow")) {
-            writeNewRow(delimiter, numberOfColumns);
-        }
-    }
+bool openOutput(Output *output, int fd, bool lineBuffered) {
+    output->fd = fd;
+    output->capacity = OUTPUT_BUFFER_SIZE;
+    output->size = 0;
+    output->lineBuffered = lineBuffered;
+    output->failed = false;
+    output->written = 0;
+    output->compressor = NULL;
+
+    return (output->buffer = malloc(output->capacity)) != NULL;
 }
 
 /**
- * Applies data processing function on provided row
- * @param row Input row
- * @param function Function to use
- * @param delimiter Column delimiter
- * @param numberOfColumns Number of column in the row
- * @return Error information
+ * Releases resources of the output (data that haven't been flushed are lost)
+ * @param output Output to close
  */
-ErrorInfo applyDataProcessingFunction(Row *row, Function function, char delimiter, int numberOfColumns) {
-    ErrorInfo errorInfo = {false};
+void closeOutput(Output *output) {
+    closeCompressor(output);
+    free(output->buffer);
+    output->buffer = NULL;
+}
 
-    if (streq(function.name, "cset")) {
-        return cset(function.params[0], function.strParams[1], row, delimiter, numberOfColumns);
-    } else if (streq(function.name, "tolower")) {
-        changeColumnCase(LOWER_CASE, function.params[0], row, delimiter, numberOfColumns);
+/**
+ * Writes all data waiting in output buffer
+ * @param output Output to flush
+ * @return Was it successful? It's false if any write to the output failed.
+ */
+bool flushOutput(Output *output) {
+    // Compressed output writes only data produced by compression (some of them stay in the compression state)
+    if (output->compressor != NULL) {
+        compressOutput(output, false);
+    } else {
+        writeOutputData(output, output->buffer, output->size);
+    }
+    output->size = 0;
 
-        return errorInfo;
-    } else if (streq(function.name, "toupper")) {
-        changeColumnCase(UPPER_CASE, function.params[0], row, delimiter, numberOfColumns);
+    return output->failed == false;
+}
 
-        return errorInfo;
-    } else if(streq(function.name, "round")) {
-        return roundColumnValue(function.params[0], row, delimiter, numberOfColumns);
-    } else if (streq(function.name, "int")) {
-        return removeColumnDecimalPart(function.params[0], row, delimiter, numberOfColumns);
-    } else if (streq(function.name, "copy")) {
-        copy(function.params[0], function.params[1], row, delimiter, numberOfColumns);
+/**
+ * Writes all data waiting in output and ends compressed data (no data can be written after it)
+ * @param output Output to finish
+ * @return Was it successful? It's false if any write to the output failed.
+ */
+bool finishOutput(Output *output) {
+    if (output->compressor == NULL) {
+        return flushOutput(output);
+    }
 
-        return errorInfo;
-    } else if (streq(function.name, "swap")) {
-        swap(function.params[0], function.params[1], row, delimiter, numberOfColumns);
+    compressOutput(output, true);
+    output->size = 0;
 
-        return errorInfo;
-    } else if (streq(function.name, "move")) {
-        move(function.params[0], function.params[1], row, delimiter, numberOfColumns);
+    return output->failed == false;
+}
 
-        return errorInfo;
+/**
+ * Writes data to the file of the output (writing stops after the first failed write)
+ * @param output Output with the file
+ * @param data Data to write
+ * @param size Size of the data
+ */
+void writeOutputData(Output *output, const char *data, size_t size) {
+    size_t written = 0;
+    while (written < size && output->failed == false) {
+        ssize_t result = write(output->fd, &data[written], size - written);
+        if (result >= 0) {
+            written += result;
+            output->written += result;
+        } else if (errno != EINTR) {
+            output->failed = true;
+        }
     }
-
-    errorInfo.message = "NO_FUNCTION_USED";
-    return errorInfo;
 }
 
 /**
- * Checks if the row accepts the selection
- * @param result Accepts this row provided selection?
- * @param row Row for check
- * @param selection Operated selection
- * @param delimiter Column delimiter
- * @param numberOfColumns Number of columns in the row
- * @return Error information
+ * Prepares space for data in output buffer (output collected in memory grows, other output is flushed)
+ * @param output Output to prepare
+ * @param size Number of bytes to prepare space for
+ * @return Is there enough space? If false, data are bigger than the whole buffer (or there isn't enough memory).
  */
-ErrorInfo acceptsSelection(bool *result, Row *row, SelectFunction *selection, char delimiter, int numberOfColumns) {
-    ErrorInfo errorInfo = {false};
+bool reserveOutput(Output *output, int size) {
+    if (output->size + size <= output->capacity) {
+        return true;
+    }
 
-    if (streq(selection->name, "rows")) {
-        if ((selection->params[0] != NO_SELECTION) && (selection->params[1] != LAST_ROW_NUMBER)) {
-            // Normal selection
-            if ((row->number >= selection->params[0]) && (row->number <= selection->params[1])) {
-                *result = true;
-                return errorInfo;
-            }
-        } else if ((selection->params[0] == LAST_ROW_NUMBER) && (selection->params[1] == LAST_ROW_NUMBER)) {
-            // Selection for the last file only
-            if (row->last == true) {
-                *result = true;
-                return errorInfo;
-            }
-        } else if ((selection->params[0] != NO_SELECTION) && (selection->params[1] == LAST_ROW_NUMBER)) {
-            // Selection from N to end of file
-            if (row->number >= selection->params[0]) {
-                *result = true;
-                return errorInfo;
-            }
+    if (output->fd < 0) {
+        int capacity = output->capacity;
+        while (capacity < output->size + size) {
+            capacity *= 2;
         }
 
-        *result = false;
-        return errorInfo;
-    } else if (streq(selection->name, "beginswith")) {
-        char value[MAX_CELL_SIZE];
-        getColumnValue(value, row, selection->params[0], delimiter, numberOfColumns);
+        char *buffer = realloc(output->buffer, capacity);
+        if (buffer == NULL) {
+            output->failed = true;
 
-        char *found = strstr(value, selection->strParams[1]);
-        if (found != NULL && streq(found, value)) {
-            *result = true;
-            return errorInfo;
+            return false;
         }
 
-        *result = false;
-        return errorInfo;
-    } else if (streq(selection->name, "contains")) {
-        char value[MAX_CELL_SIZE];
-        getColumnValue(value, row, selection->params[0], delimiter, numberOfColumns);
+        output->buffer = buffer;
+        output->capacity = capacity;
 
-        if (strstr(value, selection->strParams[1]) != NULL) {
-            *result = true;
-            return errorInfo;
+        return true;
+    }
+
+    flushOutput(output);
+
+    return size <= output->capacity;
+}
+
+/**
+ * Writes data to output (through its buffer)
+ * @param output Output to write to
+ * @param data Data to write
+ * @param size Number of bytes to write
+ */
+void writeOutput(Output *output, const char *data, int size) {
+    if (reserveOutput(output, size) == false) {
+        // Data bigger than the whole buffer are written directly
+        if (output->fd >= 0) {
+            Output direct = *output;
+            direct.buffer = (char *)data;
+            direct.size = size;
+            flushOutput(&direct);
+            output->failed = direct.failed;
+            output->written = direct.written;
         }
 
-        *result = false;
-        return errorInfo;
+        return;
     }
 
-    // No selection used --> row can be changed
-    *result = true;
-    return errorInfo;
+    memcpy(&output->buffer[output->size], data, size);
+    output->size += size;
 }
 
-/**********************************************************************************************Table editing functions*/
 /**
- * Marks rows from selected interval as deleted
- * @param from First selected row
- * @param to Last selected row
- * @param row Actual row
- * @return Error information
+ * Writes already processed row to output (overridden cells are written between unchanged parts of row's data)
+ * @param output Output to write to
+ * @param row Processed row
  */
-ErrorInfo drows(int from, int to, Row *row) {
-    ErrorInfo errorInfo = {false};
+void writeProcessedRow(Output *output, const Row *row) {
+    if (row->numberOfOverrides == 0) {
+        writeOutput(output, row->data, row->size);
+    } else {
+        writeOverriddenRow(output, row);
+    }
 
-    if (from > to) {
-        errorInfo.error = true;
-        errorInfo.message = "Byl zadan chybny interval - prvni cislo musi byt mensi nez druhe.";
+    if (output->lineBuffered == true) {
+        flushOutput(output);
+    }
+}
 
-        return errorInfo;
+/**
+ * Writes row with overridden cells to output (they're written between unchanged parts of row's data)
+ * @param output Output to write to
+ * @param row Processed row with overridden cells
+ */
+void writeOverriddenRow(Output *output, const Row *row) {
+    const char *segments[2 * MAX_CELL_OVERRIDES + 1];
+    int sizes[2 * MAX_CELL_OVERRIDES + 1];
+    int numberOfSegments = 0;
+    int size = 0;
+
+    // Overrides are written in order of their cells
+    int position = 0;
+    int previous = 0;
+    for (int i = 0; i < row->numberOfOverrides; i++) {
+        const CellOverride *next = NULL;
+        for (int j = 0; j < row->numberOfOverrides; j++) {
+            const CellOverride *override = &row->overrides[j];
+            if (override->column > previous && (next == NULL || override->column < next->column)) {
+                next = override;
+            }
+        }
+
+        int start = getCellStart(row, next->column);
+        segments[numberOfSegments] = &row->data[position];
+        sizes[numberOfSegments++] = start - position;
+        segments[numberOfSegments] = next->value;
+        sizes[numberOfSegments++] = next->size;
+        size += start - position + next->size;
+
+        position = start + getCellSize(row, next->column);
+        previous = next->column;
     }
+    segments[numberOfSegments] = &row->data[position];
+    sizes[numberOfSegments++] = row->size - position;
+    size += row->size - position;
+
+    // Segments are gathered in the output buffer at once (unless the row is bigger than the buffer)
+    if (reserveOutput(output, size) == false) {
+        for (int i = 0; i < numberOfSegments; i++) {
+            writeOutput(output, segments[i], sizes[i]);
+        }
 
-    if (row->number >= from && row->number <= to) {
-        row->deleted = true;
+        return;
     }
 
-    return errorInfo;
+    for (int i = 0; i < numberOfSegments; i++) {
+        memcpy(&output->buffer[output->size], segments[i], sizes[i]);
+        output->size += sizes[i];
+    }
 }
 
 /**
- * Adds column before selected column
- * @param column Selected column
- * @param row Row to change
+ * Writes row rearranged by table layout to output (parts of the row are gathered directly from the input data)
+ * @param output Output to write to
+ * @param row Indexed input row (without overridden cells, column editing and data processing functions aren't combined)
+ * @param layout Layout of output rows
  * @param delimiter Column delimiter
- * @param numberOfColumns Number of columns in the row
- * @return Error information
  */
-ErrorInfo icol(int column, Row *row, char delimiter, int *numberOfColumns) {
-    ErrorInfo errorInfo = {false};
-
-    if ((row->size + 1) > MAX_ROW_SIZE) {
-        errorInfo.error = true;
-        errorInfo.message = "Provedenim prikazu icol byla prekrocena maximalni velikost radku.";
+void writeRearrangedRow(Output *output, const Row *row, const TableLayout *layout, char delimiter) {
+    for (int i = 0; i < layout->numberOfSpans; i++) {
+        const ColumnSpan *span = &layout->spans[i];
+        if (i > 0) {
+            writeOutput(output, &delimiter, 1);
+        }
 
-        return errorInfo;
+        if (span->first != NEW_COLUMN) {
+            int start = getCellStart(row, span->first);
+            writeOutput(output, &row->data[start], row->cells[span->last] - 1 - start);
+        }
     }
 
-    char columnValue[MAX_CELL_SIZE];
-    getColumnValue(columnValue, row, column, delimiter, *numberOfColumns);
+    if (layout->newLine == true || (row->size > 0 && row->data[row->size - 1] == '\n')) {
+        writeOutput(output, "\n", 1);
+    }
 
-    char newColumnValue[MAX_CELL_SIZE];
-    memset(newColumnValue, '\0', sizeof(newColumnValue));
-    newColumnValue[0] = delimiter;
-    strcat(newColumnValue, columnValue);
+    if (output->lineBuffered == true) {
+        flushOutput(output);
+    }
+}
 
-    // Row should exists - last operation on it ended with success
-    setColumnValue(newColumnValue, row, column, delimiter, *numberOfColumns);
+/**
+ * Writes new rows to output (by the template of new rows)
+ * @param output Output to write to
+ * @param layout Layout of output rows with the template
+ * @param count Number of new rows
+ */
+void writeNewRows(Output *output, const TableLayout *layout, long long count) {
+    for (long long i = 0; i < count; i++) {
+        writeOutput(output, layout->newRow, layout->newRowSize);
+    }
 
-    // Do it only once
-    if (row->number == 1) {
-        (*numberOfColumns)++;
+    if (output->lineBuffered == true) {
+        flushOutput(output);
     }
+}
 
-    return errorInfo;
+/**
+ * Writes error message to standard error output
+ * @param message Error message
+ */
+void writeErrorMessage(const char *message) {
+    fprintf(stderr, "sheet: %s", message);
 }
 
+/******************************************************************************************Main control and processing*/
 /**
- * Append column to the end of the row
- * @param row Row to change
- * @param delimiter Column delimiter
- * @param numberOfColumns Number of column in the row
- * @return Error info
+ * Prepares look-up table of char classes for used delimiters and selects the fastest kernel for indexing cells
+ * @param delimiters Prepared delimiters
+ * @param string Used delimiters (from -d option); the first one is the main delimiter
  */
-ErrorInfo acol(Row *row, char delimiter, int *numberOfColumns) {
-    ErrorInfo errorInfo = {false};
+void prepareDelimiters(Delimiters *delimiters, const char *string) {
+    memset(delimiters->classes, OTHER_CHAR, sizeof(delimiters->classes));
+    delimiters->classes['\n'] = NEW_LINE_CHAR;
 
-    if ((row->size + 1) > MAX_ROW_SIZE) {
-        errorInfo.error = true;
-        errorInfo.message = "Provedenim prikazu acol byla prekrocena maximalni velikost radku.";
+    for (int i = 0; string[i] != '\0'; i++) {
+        delimiters->classes[(unsigned char) string[i]] = DELIMITER_CHAR;
+    }
 
-        return errorInfo;
+    delimiters->main = string[0];
+    delimiters->classes[(unsigned char) delimiters->main] = MAIN_DELIMITER_CHAR;
+
+    delimiters->numberOfOthers = 0;
+    for (int c = 0; c <= UCHAR_MAX; c++) {
+        if (delimiters->classes[c] == DELIMITER_CHAR) {
+            delimiters->others[delimiters->numberOfOthers++] = (char) c;
+        }
     }
 
-    row->data[row->size - 1] = delimiter;
-    row->data[row->size] = '\n';
-    row->size++;
+    // Single delimiter doesn't need any unification, so its kernels only search for it
+    if (delimiters->numberOfOthers == 0) {
+        delimiters->indexCells = indexCellsSingle;
+#if defined(X86_SIMD)
+        if (__builtin_cpu_supports("avx2")) {
+            delimiters->indexCells = indexCellsSingleAvx2;
+        } else if (__builtin_cpu_supports("sse2")) {
+            delimiters->indexCells = indexCellsSingleSse2;
+        }
+#elif defined(NEON_SIMD)
+        delimiters->indexCells = indexCellsNeon;
+#endif
 
-    // Do it only once
-    if (row->number == 1) {
-        (*numberOfColumns)++;
+        return;
     }
 
-    return errorInfo;
+    // SIMD kernels compare blocks of data with each delimiter separately, so they're good for a few delimiters only
+    delimiters->indexCells = indexCellsScalar;
+    if (delimiters->numberOfOthers <= MAX_SIMD_DELIMITERS) {
+#if defined(X86_SIMD)
+        if (__builtin_cpu_supports("avx2")) {
+            delimiters->indexCells = indexCellsAvx2;
+        } else if (__builtin_cpu_supports("sse2")) {
+            delimiters->indexCells = indexCellsSse2;
+        }
+#elif defined(NEON_SIMD)
+        delimiters->indexCells = indexCellsNeon;
+#endif
+    }
 }
 
 /**
- * Deletes row's columns from selected range
- * @param from First selected column number
- * @param to Last selected column number
- * @param row Operated row
- * @param delimiter Column delimiter
+ * Processes table from input to output
+ * @param input Input with table
+ * @param output Output for processed table
+ * @param functions Parsed and verified functions to apply
+ * @param delimiters Used delimiters
+ * @param stats Statistics of processing (NULL if they aren't collected)
  * @return Error information
  */
-ErrorInfo dcols(int from, int to, Row *row, char delimiter) {
-    ErrorInfo errorInfo = {false};
+ErrorInfo processTable(Input *input, Output *output, const Function *functions, const Delimiters *delimiters,
+                       Stats *stats) {
+    ErrorInfo err;
 
-    if (from > to) {
-        errorInfo.error = true;
-        errorInfo.message = "Byl zadan chybny interval - prvni cislo musi byt mensi nez druhe.";
+    Arena arena = {NULL};
+    Row row = {.size = 0, .number = 0, .last = false, .arena = &arena};
+    TableLayout layout = {NULL}; // It's prepared by the first row of the table
+    err = processRows(input, output, functions, delimiters, &row, &layout, stats);
+    freeArena(&arena);
+    if (err.error == false) {
+        err = finishTable(output, functions, &layout, row.number, stats);
+    }
+    freeTableLayout(&layout);
 
-        return errorInfo;
+    return err;
+}
+
+/**
+ * Processes rows from input to output
+ * @param input Input with rows
+ * @param output Output for processed rows
+ * @param functions Parsed and verified functions to apply
+ * @param delimiters Used delimiters
+ * @param row Row for loading rows (with number of the row before the first one)
+ * @param layout Layout of output rows (it's prepared by the first row of the table)
+ * @param stats Statistics of processing (NULL if they aren't collected)
+ * @return Error information
+ */
+ErrorInfo processRows(Input *input, Output *output, const Function *functions, const Delimiters *delimiters, Row *row,
+                      TableLayout *layout, Stats *stats) {
+    // Data processing function can be applied to more rows at once if they stay in memory
+    if (isBatchable(input, functions) == true) {
+        return processBatches(input, output, functions, delimiters, row, layout, stats);
     }
 
-    // Backup for future recovery + clean row
-    char rowBackup[MAX_ROW_SIZE];
-    memmove(rowBackup, row->data, MAX_ROW_SIZE);
-    memset(row->data, '\0', MAX_ROW_SIZE);
+    ErrorInfo err = {false};
+
+    char delimiter = delimiters->main;
+    const SelectFunction *rowsSelection = getRowsSelection(functions);
+    while (true) {
+        // Statistics need sizes of all rows and other delimiters must be unified, so unaffected rows are copied at once
+        // only without them
+        if (input->index != NULL && stats == NULL && delimiters->numberOfOthers == 0 && row->number > 0) {
+            copyUnaffectedRows(input, output, row, functions);
+        }
+
+        // Times are measured only for some rows, so collecting statistics doesn't slow down processing much
+        bool sampled = isSampled(stats);
+        long long start = startMeasure(sampled);
+        resetArena(row->arena);
+        if (loadRow(row, input) == false) {
+            break;
+        }
+        endMeasure(stats, INPUT_COUNTER, start, sampled);
+
+        // Rows not selected by their numbers are only validated and written as they are (cells aren't indexed)
+        bool selected = false;
+        if (rowsSelection != NULL && row->number > 1) {
+            start = startMeasure(sampled);
+            selected = acceptsSelection(row, rowsSelection);
+            endMeasure(stats, SELECTION_COUNTER, start, sampled);
+        }
+        if (rowsSelection != NULL && row->number > 1 && selected == false) {
+            // Cells of validated rows are already counted (other delimiters must be unified anyway)
+            start = startMeasure(sampled);
+            int numberOfCells = input->numberOfColumns;
+            if (numberOfCells == 0 || delimiters->numberOfOthers > 0) {
+                numberOfCells = countRowCells(row, delimiters);
+            }
+            endMeasure(stats, DELIMITERS_COUNTER, start, sampled);
+            addRowStats(stats, row, false);
+            if (row->outOfMemory == true) {
+                err.error = true;
+                err.message = "Nedostatek pameti pro zpracovani radku.";
+
+                return err;
+            }
+            if (numberOfCells != layout->inputNumOfCols) {
+                err.error = true;
+                err.message = "Kazdy radek musi mit stejny pocet sloupcu.";
+
+                return err;
+            }
+
+            start = startMeasure(sampled);
+            writeProcessedRow(output, row);
+            endMeasure(stats, OUTPUT_COUNTER, start, sampled);
+            continue;
+        }
+
+        // Validation (and delimiter processing)
+        start = startMeasure(sampled);
+        err = verifyRow(row, delimiters);
+        endMeasure(stats, DELIMITERS_COUNTER, start, sampled);
+        addRowStats(stats, row, err.error == false);
+        if (err.error == true) {
+            return err;
+        }
 
-    // Recovery only data of non-deleted columns
-    int counter = 1; // Actual number of column, column numbering starts from 1
-    int dataIndex = 0;
-    for (int j = 0; j < row->size; j++) {
-        if (!((counter >= from) && (counter <= to))) {
-            row->data[dataIndex] = rowBackup[j];
-            dataIndex++;
-        } else if (j == (row->size - 1)) {
-            // The last column is being removed, so end delimiter must be deleted
-            dataIndex--;
-            row->data[dataIndex] = '\0';
+        // Data processing
+        start = startMeasure(sampled);
+        if(row->number == 1) {
+            err = prepareTableLayout(layout, functions, row->numberOfCells, delimiter);
+        } else if (row->numberOfCells != layout->inputNumOfCols) {
+            err.error = true;
+            err.message = "Kazdy radek musi mit stejny pocet sloupcu.";
+        }
+        endMeasure(stats, VERIFICATION_COUNTER, start, sampled);
+        if (err.error == true) {
+            return err;
         }
 
-        if(rowBackup[j] == delimiter) {
-            counter++;
+        err = applyFunctions(row, functions, layout, selected, delimiter, output, stats, sampled);
+        if (err.error == true) {
+            return err;
         }
     }
 
-    // Recount row's size and ensure \n at the end of the row
-    row->size = (int)strlen(row->data);
-    if (row->data[row->size - 1] != '\n') {
-        row->data[row->size] = '\n';
-        row->size++;
+    // The rest of input couldn't be loaded
+    if (input->failed == true) {
+        err.error = true;
+        err.message = "Nedostatek pameti pro nacitani vstupu.";
     }
 
-    return errorInfo;
+    return err;
 }
 
-/********************************************************************************************Data processing functions*/
 /**
- * Sets selected column's value
- * @param column Selected column's number
- * @param value Value to set to the column
- * @param row Row contains the column
+ * Applies functions to the verified row and writes it to output (see processRows())
+ * @param row Verified row with indexed cells
+ * @param functions Parsed and verified functions to apply
+ * @param layout Layout of output rows
+ * @param selected Has the row been already selected by rows selection? (see getRowsSelection())
  * @param delimiter Column delimiter
- * @param numberOfColumns Number of column in the row
+ * @param output Output for the processed row (and new rows inserted before it)
+ * @param stats Statistics of processing (NULL if they aren't collected)
+ * @param sampled Is time of the row measured? (see isSampled())
  * @return Error information
  */
-ErrorInfo cset(int column, char *value, Row *row, char delimiter, int numberOfColumns) {
-    ErrorInfo errorInfo = {false};
+ErrorInfo applyFunctions(Row *row, const Function *functions, const TableLayout *layout, bool selected, char delimiter,
+                         Output *output, Stats *stats, bool sampled) {
+    ErrorInfo err = {false};
+    long long start;
+
+    // New rows of all irow functions are found at once (see prepareRowInsertions())
+    long long inserted = getInsertedRows(layout, row->number);
+    if (inserted > 0) {
+        writeNewRows(output, layout, inserted);
+        if (stats != NULL) {
+            stats->rowsInserted += inserted;
+        }
+    }
 
-    if ((int)strlen(value) > MAX_CELL_SIZE) {
-        errorInfo.error = true;
-        errorInfo.message = "Hodnota predana funkci cset prekracuje maximalni velikost bunky.";
+    // Combinations of functions have already been checked by verifyFunctions()
+    for (int i = 0; functions[i].type != NO_FUNCTION && row->outOfMemory == false; i++) {
+        const Function *function = &functions[i];
 
-        return errorInfo;
+        // Table editing functions
+        if (functionDefinitions[function->type].tableEditing == true) {
+            start = startMeasure(sampled);
+            applyTableEditingFunction(row, function);
+            endMeasure(stats, FUNCTION_COUNTER + i, start, sampled);
+
+            // Does not make sense to continue with processing if the row was marked as deleted
+            if (row->deleted == true) {
+                break;
+            }
+
+            continue;
+        }
+
+        // Row selection (don't modify some rows with actual function; rows selection could be already resolved)
+        if (selected == false) {
+            start = startMeasure(sampled);
+            bool accepted = acceptsSelection(row, &function->selectFunction);
+            endMeasure(stats, SELECTION_COUNTER, start, sampled);
+            if (accepted == false) {
+                continue;
+            }
+        }
+        if (stats != NULL && function->selectFunction.type != ALL_ROWS) {
+            stats->rowsSelected++;
+        }
+
+        // Data processing functions
+        start = startMeasure(sampled);
+        err = applyDataProcessingFunction(row, function, delimiter);
+        endMeasure(stats, FUNCTION_COUNTER + i, start, sampled);
+        if (err.error == true) {
+            return err;
+        }
     }
 
-    setColumnValue(value, row, column, delimiter, numberOfColumns);
+    if (row->outOfMemory == true) {
+        err.error = true;
+        err.message = "Nedostatek pameti pro zpracovani radku.";
 
-    return errorInfo;
+        return err;
+    }
+
+    // Write output
+    if (row->deleted == true) {
+        if (stats != NULL) {
+            stats->rowsDeleted++;
+        }
+
+        return err;
+    }
+
+    start = startMeasure(sampled);
+    if (layout->rearranged == true) {
+        writeRearrangedRow(output, row, layout, delimiter);
+    } else {
+        writeProcessedRow(output, row);
+    }
+    endMeasure(stats, OUTPUT_COUNTER, start, sampled);
+
+    return err;
 }
 
 /**
- * Changes column's case of selected column
- * @param newCase New case (LOWER_CASE or UPPER_CASE)
- * @param column Selected column
- * @param row Row contains the column
- * @param delimiter Column delimiter
- * @param numberOfColumns Number of columns in the row
+ * Finishes the table after processing all rows
+ * @param output Output for new rows
+ * @param functions Parsed and verified functions to apply
+ * @param layout Layout of output rows (it isn't prepared for empty input)
+ * @param numberOfRows Number of input rows
+ * @param stats Statistics of processing (NULL if they aren't collected)
+ * @return Error information
  */
-void changeColumnCase(bool newCase, int column, Row *row, char delimiter, int numberOfColumns) {
-    char value[MAX_CELL_SIZE];
-    getColumnValue(value, row, column, delimiter, numberOfColumns);
+ErrorInfo finishTable(Output *output, const Function *functions, const TableLayout *layout, int numberOfRows,
+                      Stats *stats) {
+    ErrorInfo err = {false};
 
-    int shift;
-    char start;
-    if (newCase == LOWER_CASE) {
-        start = 'A';
-        shift = ('a' - 'A');
-    } else {
-        start = 'a';
-        shift = -('a' - 'A');
+    // Empty input
+    if (numberOfRows == 0) {
+        err.error = true;
+        err.message = "Prazdny vstup neni povolen.";
+
+        return err;
     }
 
-    for (int j = 0; j < (int)strlen(value); j++) {
-        if ((value[j] >= start) && (value[j] <= start + ('z' - 'a'))) {
-            value[j] = (char)(value[j] + shift);
+    // New content
+    applyAppendRowFunctions(output, functions, layout);
+    for (int i = 0; stats != NULL && functions[i].type != NO_FUNCTION; i++) {
+        if (functions[i].type == AROW) {
+            stats->rowsInserted += functions[i].params[0];
         }
     }
-    // It should be OK (it has been read from this column yet)
-    setColumnValue(value, row, column, delimiter, numberOfColumns);
+
+    return err;
 }
 
 /**
- * Rounds value in selected column
- * @param column Selected column
- * @param row Row contains the column
+ * Verifies input conditions for row, unifies its delimiters and indexes its cells (see indexRowCells())
+ * @param row Row to be checked
  * @param delimiter Column delimiter
- * @param numberOfColumns Number of column in the row
- * @return Error information
+ * @return Is the row valid?
  */
-ErrorInfo roundColumnValue(int column, Row *row, char delimiter, int numberOfColumns) {
+ErrorInfo verifyRow(Row *row, const Delimiters *delimiters) {
     ErrorInfo errorInfo = {false};
 
-    char value[MAX_CELL_SIZE];
-    getColumnValue(value, row, column, delimiter, numberOfColumns);
+    // Cells are indexed only once, all functions use the index instead of searching for delimiters
+    indexRowCells(row, delimiters);
 
-    // The cells must contains valid number
-    if (isValidNumber(value) == false) {
+    // Rows and cells can have any size, but there must be enough memory for them
+    if (row->outOfMemory == true) {
         errorInfo.error = true;
-        errorInfo.message = "Funkci round nelze provest na bunce, ktera neobsahuje validni cislo.";
+        errorInfo.message = "Nedostatek pameti pro zpracovani radku.";
 
         return errorInfo;
     }
 
-    double number = strtod(value, NULL);
-    memset(value, '\0', strlen(value));
-    sprintf(value, "%.f", number);
-
-    // Should be OK (this column has already been used)
-    setColumnValue(value, row, column, delimiter, numberOfColumns);
-
     return errorInfo;
 }
 
 /**
- * Removes decimal part from selected column's value (only removes, without rounding)
- * @param column Selected column
- * @param row Row contains the column
- * @param delimiter Column delimiter
- * @param numberOfColumns Number of columns in the row
+ * Parses arguments into functions (instances of Function data type)
+ * @param functions Pointer to array fro saving parsed output
+ * @param args Program input arguments
  * @return Error information
  */
-ErrorInfo removeColumnDecimalPart(int column, Row *row, char delimiter, int numberOfColumns) {
+ErrorInfo parseInputArguments(Function *functions, const InputArguments *args) {
     ErrorInfo errorInfo = {false};
 
-    char value[MAX_CELL_SIZE];
-    getColumnValue(value, row, column, delimiter, numberOfColumns);
+    int funcIndex = 0;
+    for (int i = args->skipped; i < args->size; i++) {
+        if (funcIndex == MAX_FUNCTIONS) {
+            errorInfo.error = true;
+            errorInfo.message = "Byl prekrocen maximalni pocet funkci.";
+
+            return errorInfo;
+        }
 
-    // The cells must contains valid number
-    if (isValidNumber(value) == false) {
-        errorInfo.error = true;
-        errorInfo.message = "Funkci round nelze provest na bunce, ktera neobsahuje validni cislo.";
+        if ((errorInfo = getFunctionFromArgs(&functions[funcIndex], args, &i)).error == true) {
+            return errorInfo;
+        }
 
-        return errorInfo;
+        funcIndex++;
     }
 
-    double number = strtod(value, NULL);
-    memset(value, '\0', strlen(value));
-    sprintf(value, "%d", (int)number);
-    // Should be OK (this column has already been used)
-    setColumnValue(value, row, column, delimiter, numberOfColumns);
+    // End of the functions array
+    functions[funcIndex].type = NO_FUNCTION;
 
     return errorInfo;
 }
 
 /**
- * Copies column's value to another column
- * @param from Source column
- * @param to Target column
- * @param row Row contains columns
- * @param delimiter Column delimiter
- * @param numberOfColumns Number of columns in the row
+ * Verifies parsed functions (their combinations and parameters' values), so it's not needed to do it for every row
+ * @param functions Parsed functions (terminated by NO_FUNCTION)
+ * @return Error information
  */
-void copy(int from, int to, Row *row, char delimiter, int numberOfColumns) {
-    // One of the selected columns doesn't exists, so this function can't change anything
-    if ((from > numberOfColumns) || (to > numberOfColumns)) {
-        return;
-    }
+ErrorInfo verifyFunctions(const Function *functions) {
+    ErrorInfo errorInfo = {false};
 
-    char value[MAX_CELL_SIZE];
-    getColumnValue(value, row, from, delimiter, numberOfColumns);
+    int tableEditing = 0;
+    int dataProcessing = 0;
+    for (int i = 0; functions[i].type != NO_FUNCTION; i++) {
+        const Function *function = &functions[i];
 
-    setColumnValue(value, row, to, delimiter, numberOfColumns);
-}
+        if (functionDefinitions[function->type].tableEditing == true) {
+            // Selections on table editing functions are forbidden
+            if (function->selectFunction.type != ALL_ROWS) {
+                errorInfo.error = true;
+                errorInfo.message = "Funkce pro vyber radku neni mozne pouzit na funkce menici tabulku.";
 
-/**
- * Swaps values of selected columns
- * @param first First selected column
- * @param second Second selected column
+                return errorInfo;
+            }
+
+            tableEditing++;
+        } else {
+            dataProcessing++;
+        }
+
+        bool interval = function->type == DROWS || function->type == DCOLS || function->type == TOLOWER ||
+                        function->type == TOUPPER;
+        if (interval == true && function->params[0] > function->params[1]) {
+            errorInfo.error = true;
+            errorInfo.message = "Byl zadan chybny interval - prvni cislo musi byt mensi nez druhe.";
+
+            return errorInfo;
+        }
+    }
+
+    if (dataProcessing > 1) {
+        errorInfo.error = true;
+        errorInfo.message = "Je mozne pouzit pouze jednu funkci pro zpracovani dat.";
+
+        return errorInfo;
+    }
+
+    if (tableEditing > 0 && dataProcessing > 0) {
+        errorInfo.error = true;
+        errorInfo.message = "Je mozne pouzit pouze funkce pro zmenu tabulky nebo pouze pro zpracovani dat.";
+
+        return errorInfo;
+    }
+
+    return errorInfo;
+}
+
+/**
+ * Prepares layout of output rows by applying column editing functions to columns of the first row, so rows don't have
+ * to be changed by every function one by one
+ * @param layout Layout to prepare
+ * @param functions Parsed and verified functions to apply
+ * @param inputNumOfCols Number of columns in each input row
+ * @param delimiter Column delimiter (for the template of new rows)
+ * @return Error information
+ */
+ErrorInfo prepareTableLayout(TableLayout *layout, const Function *functions, int inputNumOfCols, char delimiter) {
+    ErrorInfo errorInfo = {false};
+
+    // Output columns can't be more than input columns and added ones
+    int capacity = inputNumOfCols;
+    for (int i = 0; functions[i].type != NO_FUNCTION; i++) {
+        if (functions[i].type == ICOL || functions[i].type == ACOL) {
+            capacity++;
+        }
+    }
+
+    int *columns = malloc(capacity * sizeof(int));
+    layout->spans = malloc(capacity * sizeof(ColumnSpan));
+    if (columns == NULL || layout->spans == NULL) {
+        free(columns);
+        errorInfo.error = true;
+        errorInfo.message = "Nedostatek pameti pro zpracovani tabulky.";
+
+        return errorInfo;
+    }
+
+    int count = inputNumOfCols;
+    for (int i = 0; i < count; i++) {
+        columns[i] = i + 1;
+    }
+
+    layout->inputNumOfCols = inputNumOfCols;
+    layout->newLine = false;
+    layout->rearranged = false;
+    for (int i = 0; functions[i].type != NO_FUNCTION; i++) {
+        const Function *function = &functions[i];
+        int from = function->params[0];
+        int to = function->type == DCOLS ? function->params[1] : from;
+
+        switch (function->type) {
+            case ICOL:
+                // There is no column to add the new one before
+                if (from > count) {
+                    break;
+                }
+
+                memmove(&columns[from], &columns[from - 1], (count - from + 1) * sizeof(int));
+                columns[from - 1] = NEW_COLUMN;
+                count++;
+                layout->rearranged = true;
+                break;
+            case ACOL:
+                columns[count++] = NEW_COLUMN;
+                layout->rearranged = true;
+                break;
+            case DCOL:
+            case DCOLS:
+                // Only existing columns can be deleted
+                if (from > count) {
+                    break;
+                }
+                if (to > count) {
+                    to = count;
+                }
+
+                memmove(&columns[from - 1], &columns[to], (count - to) * sizeof(int));
+                count -= to - from + 1;
+                if (count == 0) {
+                    // Row without any columns still has one empty cell
+                    columns[count++] = NEW_COLUMN;
+                }
+
+                layout->newLine = true;
+                layout->rearranged = true;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Neighbouring input columns are written at once (together with delimiters between them)
+    layout->numberOfColumns = count;
+    layout->numberOfSpans = 0;
+    int previous = NEW_COLUMN; // Last column of the previous part
+    for (int i = 0; i < count; i++) {
+        if (previous != NEW_COLUMN && columns[i] == previous + 1) {
+            layout->spans[layout->numberOfSpans - 1].last = columns[i];
+        } else {
+            layout->spans[layout->numberOfSpans++] = (ColumnSpan) {columns[i], columns[i]};
+        }
+
+        previous = columns[i];
+    }
+
+    free(columns);
+
+    // New rows are the same for the whole table
+    layout->newRowSize = count;
+    if ((layout->newRow = malloc(count)) == NULL) {
+        errorInfo.error = true;
+        errorInfo.message = "Nedostatek pameti pro zpracovani tabulky.";
+
+        return errorInfo;
+    }
+    memset(layout->newRow, delimiter, count - 1);
+    layout->newRow[count - 1] = '\n';
+
+    return prepareRowInsertions(layout, functions);
+}
+
+/**
+ * Prepares insertions of new rows by irow functions (sorted by rows, so the row is found without checking functions)
+ * @param layout Layout of output rows
+ * @param functions Parsed and verified functions
+ * @return Error information
+ */
+ErrorInfo prepareRowInsertions(TableLayout *layout, const Function *functions) {
+    ErrorInfo errorInfo = {false};
+
+    int capacity = 0;
+    for (int i = 0; functions[i].type != NO_FUNCTION; i++) {
+        if (functions[i].type == IROW) {
+            capacity++;
+        }
+    }
+
+    layout->numberOfInsertions = 0;
+    if (capacity == 0) {
+        return errorInfo;
+    }
+    if ((layout->insertions = malloc(capacity * sizeof(RowInsertion))) == NULL) {
+        errorInfo.error = true;
+        errorInfo.message = "Nedostatek pameti pro zpracovani tabulky.";
+
+        return errorInfo;
+    }
+
+    for (int i = 0; functions[i].type != NO_FUNCTION; i++) {
+        if (functions[i].type != IROW) {
+            continue;
+        }
+
+        // Row deleted by an earlier function isn't processed by the next ones (see applyFunctions())
+        int number = functions[i].params[0];
+        bool deleted = false;
+        for (int j = 0; j < i; j++) {
+            const Function *function = &functions[j];
+            int to = function->type == DROWS ? function->params[1] : function->params[0];
+            if ((function->type == DROW || function->type == DROWS) && number >= function->params[0] && number <= to) {
+                deleted = true;
+            }
+        }
+        if (deleted == true) {
+            continue;
+        }
+
+        // Insertions are kept sorted (there are only few of them), rows of the same row are merged
+        int position = 0;
+        while (position < layout->numberOfInsertions && layout->insertions[position].row < number) {
+            position++;
+        }
+        if (position < layout->numberOfInsertions && layout->insertions[position].row == number) {
+            layout->insertions[position].count += functions[i].params[1];
+            continue;
+        }
+
+        memmove(&layout->insertions[position + 1], &layout->insertions[position],
+                (layout->numberOfInsertions - position) * sizeof(RowInsertion));
+        layout->insertions[position] = (RowInsertion) {number, functions[i].params[1]};
+        layout->numberOfInsertions++;
+    }
+
+    return errorInfo;
+}
+
+/**
+ * Finds number of new rows inserted before the input row
+ * @param layout Layout of output rows with prepared insertions
+ * @param number Number of the input row
+ * @return Number of new rows (0 if there aren't any)
+ */
+long long getInsertedRows(const TableLayout *layout, int number) {
+    // The common case is only one integer comparison
+    if (layout->numberOfInsertions == 0 || number > layout->insertions[layout->numberOfInsertions - 1].row) {
+        return 0;
+    }
+
+    int low = 0;
+    int high = layout->numberOfInsertions - 1;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        if (layout->insertions[middle].row < number) {
+            low = middle + 1;
+        } else if (layout->insertions[middle].row > number) {
+            high = middle - 1;
+        } else {
+            return layout->insertions[middle].count;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Frees memory of the table layout
+ * @param layout Layout to free
+ */
+void freeTableLayout(TableLayout *layout) {
+    free(layout->spans);
+    layout->spans = NULL;
+    layout->numberOfSpans = 0;
+    free(layout->newRow);
+    layout->newRow = NULL;
+    free(layout->insertions);
+    layout->insertions = NULL;
+    layout->numberOfInsertions = 0;
+}
+
+/**
+ * Applies table editing function on provided row
+ * @param row Input (raw) row
+ * @param function Function to use
+ */
+void applyTableEditingFunction(Row *row, const Function *function) {
+    switch (function->type) {
+        case DROW:
+            drows(function->params[0], function->params[0], row);
+            break;
+        case DROWS:
+            drows(function->params[0], function->params[1], row);
+            break;
+        default:
+            // Column editing functions are applied by writing rows by table layout (see prepareTableLayout()), irow
+            // rows are written before the row (see getInsertedRows()) and arow is applied after processing all rows
+            // (see applyAppendRowFunctions())
+            break;
+    }
+}
+
+/**
+ * Applies append row functions to output
+ * @param output Output for new rows
+ * @param functions Parsed functions
+ * @param layout Layout of output rows with the template of new rows
+ */
+void applyAppendRowFunctions(Output *output, const Function *functions, const TableLayout *layout) {
+    long long count = 0;
+    for (int i = 0; functions[i].type != NO_FUNCTION; i++) {
+        if (functions[i].type == AROW) {
+            count += functions[i].params[0];
+        }
+    }
+
+    writeNewRows(output, layout, count);
+}
+
+/**
+ * Applies data processing function on provided row
+ * @param row Input row
+ * @param function Function to use
+ * @param delimiter Column delimiter
+ * @return Error information
+ */
+ErrorInfo applyDataProcessingFunction(Row *row, const Function *function, char delimiter) {
+    ErrorInfo errorInfo = {false};
+
+    switch (function->type) {
+        case CSET:
+            return cset(function->params[0], function->value, row);
+        case TOLOWER:
+            changeColumnCase(LOWER_CASE, function->params[0], function->params[1], row);
+            break;
+        case TOUPPER:
+            changeColumnCase(UPPER_CASE, function->params[0], function->params[1], row);
+            break;
+        case ROUND:
+            return roundColumnValue(function->params[0], row);
+        case INT:
+            return removeColumnDecimalPart(function->params[0], row);
+        case COPY:
+            copy(function->params[0], function->params[1], row);
+            break;
+        case SWAP:
+            swap(function->params[0], function->params[1], row);
+            break;
+        case MOVE:
+            move(function->params[0], function->params[1], row, delimiter);
+            break;
+        default:
+            // Table editing functions are applied by applyTableEditingFunction()
+            break;
+    }
+
+    return errorInfo;
+}
+
+/**
+ * Checks if the row accepts the selection
+ * @param row Row for check
+ * @return Accepts this row provided selection?
+ */
+bool acceptsSelection(const Row *row, const SelectFunction *selection) {
+    int column = selection->params[0];
+    int size = selection->params[1];
+
+    switch (selection->type) {
+        case ROWS:
+            if ((selection->params[0] != NO_SELECTION) && (selection->params[1] != LAST_ROW_NUMBER)) {
+                // Normal selection
+                return (row->number >= selection->params[0]) && (row->number <= selection->params[1]);
+            } else if ((selection->params[0] == LAST_ROW_NUMBER) && (selection->params[1] == LAST_ROW_NUMBER)) {
+                // Selection for the last file only
+                return row->last;
+            } else if ((selection->params[0] != NO_SELECTION) && (selection->params[1] == LAST_ROW_NUMBER)) {
+                // Selection from N to end of file
+                return row->number >= selection->params[0];
+            }
+
+            return false;
+        case BEGINS_WITH:
+            // Column that doesn't exist has empty value
+            if (column > row->numberOfCells) {
+                return size == 0;
+            }
+
+            return getCellSize(row, column) >= size
+                   && memcmp(&row->data[getCellStart(row, column)], selection->value, size) == 0;
+        case CONTAINS:
+            return cellContains(row, column, selection->value, size);
+        default:
+            // No selection used --> row can be changed
+            return true;
+    }
+}
+
+/**
+ * Finds selection of rows by their numbers, which can be resolved before cells of the rows are indexed
+ * @param functions Parsed and verified functions
+ * @return The rows selection or NULL if rows can't be skipped by their numbers
+ */
+const SelectFunction *getRowsSelection(const Function *functions) {
+    // Data processing function is always the only one (see verifyFunctions())
+    const Function *function = &functions[0];
+    if (function->type == NO_FUNCTION || functionDefinitions[function->type].tableEditing == true ||
+        function->selectFunction.type != ROWS) {
+        return NULL;
+    }
+
+    return &function->selectFunction;
+}
+
+/**
+ * Checks if some function is applied to the last row only (it must be known if a row is the last one when it's loaded)
+ * @param functions Parsed and verified functions
+ * @return Is the last row selected by its number? (rows - -, see acceptsSelection())
+ */
+bool needsLastRow(const Function *functions) {
+    for (int i = 0; functions[i].type != NO_FUNCTION; i++) {
+        const SelectFunction *selection = &functions[i].selectFunction;
+        if (selection->type == ROWS && selection->params[0] == LAST_ROW_NUMBER &&
+            selection->params[1] == LAST_ROW_NUMBER) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**************************************************************************************************Parallel processing*/
+/**
+ * Processes all rows of the table from input to output by more threads (rows are split into chunks)
+ * @param input Input with table's rows
+ * @param output Output for processed rows (they're written in the original order)
+ * @param functions Parsed and verified functions to apply
+ * @param delimiters Used delimiters
+ * @param numberOfThreads Number of threads processing chunks
+ * @param stats Statistics of processing (NULL if they aren't collected)
+ * @return Error information
+ */
+ErrorInfo processTableInParallel(Input *input, Output *output, const Function *functions,
+                                 const Delimiters *delimiters, int numberOfThreads, Stats *stats) {
+    ErrorInfo err = {false};
+
+    ParallelTable table = {
+            .functions = functions,
+            .delimiters = delimiters,
+            .stats = stats,
+            .numberOfChunks = numberOfThreads * CHUNKS_PER_THREAD
+    };
+    pthread_t threads[MAX_THREADS];
+    int startedThreads = 0;
+
+    // Chunks are prepared in advance, they're reused for the whole table (buffers are allocated by loadChunk())
+    bool prepared = (table.chunks = calloc(table.numberOfChunks, sizeof(Chunk))) != NULL;
+    for (int i = 0; prepared == true && i < table.numberOfChunks; i++) {
+        prepared = openOutput(&table.chunks[i].output, -1, false);
+    }
+
+    if (prepared == false) {
+        err.error = true;
+        err.message = "Nedostatek pameti pro paralelni zpracovani.";
+    }
+
+    pthread_mutex_init(&table.lock, NULL);
+    pthread_cond_init(&table.chunkLoaded, NULL);
+    pthread_cond_init(&table.chunkProcessed, NULL);
+
+    // The first chunk is processed before threads start - its first row sets the number of columns for the others
+    int nextRowNumber = 1;
+    bool end = true;
+    if (err.error == false && loadChunk(&table.chunks[0], input, nextRowNumber) == true) {
+        nextRowNumber += countChunkRows(&table.chunks[0]);
+        processChunk(&table.chunks[0], functions, delimiters, &table.layout,
+                     stats != NULL ? &table.chunks[0].stats : NULL);
+        table.chunks[0].processed = true;
+        table.loaded = table.taken = 1;
+        end = table.chunks[0].input.partial == false;
+    }
+
+    for (; end == false && startedThreads < numberOfThreads; startedThreads++) {
+        if (pthread_create(&threads[startedThreads], NULL, processChunks, &table) != 0) {
+            break;
+        }
+    }
+
+    if (end == false && startedThreads == 0) {
+        err.error = true;
+        err.message = "Nepodarilo se spustit vlakna pro paralelni zpracovani.";
+    }
+
+    int written = 0; // Number of chunks written to output so far
+    while (err.error == false && written < table.loaded) {
+        // Free places in the ring are filled with new chunks
+        while (end == false && table.loaded - written < table.numberOfChunks) {
+            Chunk *chunk = &table.chunks[table.loaded % table.numberOfChunks];
+            if (loadChunk(chunk, input, nextRowNumber) == false) {
+                end = true;
+                break;
+            }
+
+            nextRowNumber += countChunkRows(chunk);
+            end = chunk->input.partial == false;
+
+            pthread_mutex_lock(&table.lock);
+            table.loaded++;
+            pthread_cond_signal(&table.chunkLoaded);
+            pthread_mutex_unlock(&table.lock);
+        }
+
+        // Chunks are written in the original order
+        Chunk *chunk = &table.chunks[written % table.numberOfChunks];
+        pthread_mutex_lock(&table.lock);
+        while (chunk->processed == false) {
+            pthread_cond_wait(&table.chunkProcessed, &table.lock);
+        }
+        pthread_mutex_unlock(&table.lock);
+
+        writeOutput(output, chunk->output.buffer, chunk->output.size);
+        if (output->lineBuffered == true) {
+            flushOutput(output);
+        }
+
+        if ((err = chunk->err).error == false && chunk->output.failed == true) {
+            err.error = true;
+            err.message = "Nedostatek pameti pro zapis vystupu.";
+        }
+
+        if (stats != NULL) {
+            mergeStats(stats, &chunk->stats);
+            memset(&chunk->stats, 0, sizeof(Stats));
+        }
+
+        chunk->processed = false;
+        chunk->output.size = 0;
+        written++;
+    }
+
+    // Threads are stopped even if some chunks haven't been processed (after an error)
+    pthread_mutex_lock(&table.lock);
+    table.stop = true;
+    pthread_cond_broadcast(&table.chunkLoaded);
+    pthread_mutex_unlock(&table.lock);
+    for (int i = 0; i < startedThreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // The rest of input couldn't be loaded
+    if (err.error == false && input->failed == true) {
+        err.error = true;
+        err.message = "Nedostatek pameti pro nacitani vstupu.";
+    }
+
+    pthread_cond_destroy(&table.chunkProcessed);
+    pthread_cond_destroy(&table.chunkLoaded);
+    pthread_mutex_destroy(&table.lock);
+
+    for (int i = 0; table.chunks != NULL && i < table.numberOfChunks; i++) {
+        free(table.chunks[i].buffer);
+        closeOutput(&table.chunks[i].output);
+    }
+    free(table.chunks);
+
+    if (err.error == false) {
+        err = finishTable(output, functions, &table.layout, nextRowNumber - 1, stats);
+    }
+    freeTableLayout(&table.layout);
+
+    return err;
+}
+
+/**
+ * Loads next chunk of whole rows from input
+ * @param chunk Chunk to load rows to (it mustn't be in processing)
+ * @param input Input to load rows from
+ * @param firstRowNumber Number of the first row of the chunk
+ * @return Was it successful? If false, no other input is available.
+ */
+bool loadChunk(Chunk *chunk, Input *input, int firstRowNumber) {
+    // Buffer is filled as much as possible (data before the position aren't needed anymore)
+    bool end = false;
+    if (input->mapped == false) {
+        size_t keep = input->position;
+        while (end == false && (input->size < input->capacity || keep > 0)) {
+            end = fillInput(input, &keep) == false;
+        }
+
+        // There must be at least one whole row (buffer grows for very long rows)
+        size_t searched = input->position;
+        while (end == false && memchr(&input->buffer[searched], '\n', input->size - searched) == NULL) {
+            searched = input->size;
+            end = fillInput(input, &keep) == false;
+        }
+    }
+
+    size_t available = input->size - input->position;
+    if (available == 0 || input->failed == true) {
+        return false;
+    }
+
+    // Chunk ends with the last whole row (the rest of data is a part of the next chunk)
+    char *data = &input->buffer[input->position];
+    size_t size = available;
+    chunk->numberOfRows = 0;
+    if (input->index != NULL) {
+        // Indexed input is split by indexed rows, so numbers of rows in chunks are known without counting them
+        const RowIndex *index = input->index;
+        size_t next = (firstRowNumber - 1) / INDEX_STEP + 1;
+        while (next < index->numberOfOffsets && index->offsets[next] - input->position < INPUT_BLOCK_SIZE) {
+            next++;
+        }
+
+        size = next < index->numberOfOffsets ? index->offsets[next] - input->position : available;
+        chunk->numberOfRows = (next < index->numberOfOffsets ? (int)next * INDEX_STEP + 1 : index->numberOfRows + 1) -
+                              firstRowNumber;
+    } else if (input->mapped == true && available > INPUT_BLOCK_SIZE) {
+        char *newLine = memchr(&data[INPUT_BLOCK_SIZE - 1], '\n', available - INPUT_BLOCK_SIZE + 1);
+        size = newLine != NULL ? (size_t)(newLine - data) + 1 : available;
+    } else if (input->mapped == false && end == false) {
+        while (data[size - 1] != '\n') {
+            size--;
+        }
+    }
+
+    if (input->mapped == false) {
+        if (chunk->capacity < size) {
+            char *buffer = realloc(chunk->buffer, input->capacity);
+            if (buffer == NULL) {
+                input->failed = true;
+
+                return false;
+            }
+
+            chunk->buffer = buffer;
+            chunk->capacity = input->capacity;
+        }
+
+        memcpy(chunk->buffer, data, size);
+        data = chunk->buffer;
+    }
+    input->position += size;
+
+    // It's required to know if the chunk contains the last row (see loadRow()), if the last row is selected
+    bool final = input->position == input->size;
+    if (final == true && input->mapped == false && end == false) {
+        size_t keep = input->position;
+        final = input->lookahead == true && fillInput(input, &keep) == false;
+    }
+
+    // Chunk is processed as an input with all data in the buffer
+    chunk->input.fd = -1;
+    chunk->input.buffer = data;
+    chunk->input.capacity = chunk->input.size = size;
+    chunk->input.position = 0;
+    chunk->input.mapped = true;
+    chunk->input.readOnly = input->readOnly;
+    chunk->input.partial = final == false;
+    chunk->input.failed = false;
+    chunk->input.lookahead = input->lookahead;
+    chunk->input.numberOfColumns = input->numberOfColumns;
+    chunk->input.index = NULL; // Offsets in the index are offsets in the whole input
+    chunk->input.decompressor = NULL;
+    chunk->input.corrupted = false;
+
+    chunk->firstRowNumber = firstRowNumber;
+    chunk->processed = false;
+
+    return true;
+}
+
+/**
+ * Counts rows in the chunk
+ * @param chunk Loaded chunk
+ * @return Number of rows in the chunk
+ */
+int countChunkRows(const Chunk *chunk) {
+    // Rows of indexed input have been counted by the index
+    if (chunk->numberOfRows > 0) {
+        return chunk->numberOfRows;
+    }
+
+    const char *data = chunk->input.buffer;
+    size_t size = chunk->input.size;
+
+    int rows = 0;
+    const char *newLine;
+    while ((newLine = memchr(data, '\n', size)) != NULL) {
+        size -= newLine - data + 1;
+        data = newLine + 1;
+        rows++;
+    }
+
+    // The last row of input doesn't have to end with \n
+    if (size > 0) {
+        rows++;
+    }
+
+    return rows;
+}
+
+/**
+ * Processes rows of the chunk
+ * @param chunk Loaded chunk (result is saved into it)
+ * @param functions Parsed and verified functions to apply
+ * @param delimiters Used delimiters
+ * @param layout Layout of output rows (it's prepared by the first row of the table)
+ * @param stats Statistics of the chunk's processing (NULL if they aren't collected)
+ */
+void processChunk(Chunk *chunk, const Function *functions, const Delimiters *delimiters, TableLayout *layout,
+                  Stats *stats) {
+    Arena arena = {NULL};
+    Row row = {.size = 0, .number = chunk->firstRowNumber - 1, .last = false, .arena = &arena};
+
+    chunk->err = processRows(&chunk->input, &chunk->output, functions, delimiters, &row, layout, stats);
+    freeArena(&arena);
+}
+
+/**
+ * Processes loaded chunks until the table is stopped (thread's main function)
+ * @param parallelTable Processed table (ParallelTable)
+ * @return Nothing (NULL)
+ */
+void *processChunks(void *parallelTable) {
+    ParallelTable *table = parallelTable;
+
+    while (true) {
+        pthread_mutex_lock(&table->lock);
+        while (table->taken == table->loaded && table->stop == false) {
+            pthread_cond_wait(&table->chunkLoaded, &table->lock);
+        }
+
+        if (table->stop == true) {
+            pthread_mutex_unlock(&table->lock);
+
+            return NULL;
+        }
+
+        Chunk *chunk = &table->chunks[table->taken % table->numberOfChunks];
+        table->taken++;
+        pthread_mutex_unlock(&table->lock);
+
+        // Layout doesn't change after the first row, so all threads can share it
+        processChunk(chunk, table->functions, table->delimiters, &table->layout,
+                     table->stats != NULL ? &chunk->stats : NULL);
+
+        pthread_mutex_lock(&table->lock);
+        chunk->processed = true;
+        pthread_cond_signal(&table->chunkProcessed);
+        pthread_mutex_unlock(&table->lock);
+    }
+}
+
+/**
+ * Processes all rows of the table from input to output by a pipeline of stages (loading of chunks and their processing
+ * run in their own threads, writing runs in the calling thread, so waiting for input and output overlaps with
+ * processing)
+ * @param input Input with table's rows
+ * @param output Output for processed rows
+ * @param functions Parsed and verified functions to apply
+ * @param delimiters Used delimiters
+ * @param stats Statistics of processing (NULL if they aren't collected)
+ * @return Error information
+ */
+ErrorInfo processTableInPipeline(Input *input, Output *output, const Function *functions,
+                                 const Delimiters *delimiters, Stats *stats) {
+    ErrorInfo err = {false};
+
+    // Table is quite big (it contains the whole ring), so it mustn't be on the stack
+    PipelineTable *table = calloc(1, sizeof(PipelineTable));
+    if (table == NULL) {
+        err.error = true;
+        err.message = "Nedostatek pameti pro paralelni zpracovani.";
+
+        return err;
+    }
+
+    table->functions = functions;
+    table->delimiters = delimiters;
+    table->stats = stats;
+    table->input = input;
+    table->numberOfChunks = PIPELINE_CHUNKS;
+
+    // Chunks are reused for the whole table (buffers are allocated by loadChunk())
+    bool prepared = true;
+    for (int i = 0; prepared == true && i < table->numberOfChunks; i++) {
+        prepared = openOutput(&table->chunks[i].output, -1, false);
+    }
+
+    pthread_mutex_init(&table->lock, NULL);
+    pthread_cond_init(&table->progress, NULL);
+
+    pthread_t loadingThread, processingThread;
+    bool loadingStarted = prepared == true &&
+                          pthread_create(&loadingThread, NULL, loadPipelineChunks, table) == 0;
+    bool processingStarted = loadingStarted == true &&
+                             pthread_create(&processingThread, NULL, processPipelineChunks, table) == 0;
+
+    if (prepared == false) {
+        err.error = true;
+        err.message = "Nedostatek pameti pro paralelni zpracovani.";
+    } else if (processingStarted == false) {
+        err.error = true;
+        err.message = "Nepodarilo se spustit vlakna pro paralelni zpracovani.";
+    }
+
+    // Chunks are written in the original order (the processing stage works with them in this order, too)
+    int written = 0;
+    while (err.error == false && waitForChunks(table, &table->processed, written + 1,
+                                               &table->processingFinished) == true) {
+        Chunk *chunk = &table->chunks[written % table->numberOfChunks];
+
+        writeOutput(output, chunk->output.buffer, chunk->output.size);
+        if (output->lineBuffered == true) {
+            flushOutput(output);
+        }
+
+        if ((err = chunk->err).error == false && chunk->output.failed == true) {
+            err.error = true;
+            err.message = "Nedostatek pameti pro zapis vystupu.";
+        }
+
+        if (stats != NULL) {
+            mergeStats(stats, &chunk->stats);
+            memset(&chunk->stats, 0, sizeof(Stats));
+        }
+
+        chunk->output.size = 0;
+        advanceStage(table, &table->written, ++written);
+    }
+
+    // Other stages are stopped even if some chunks haven't been processed (after an error)
+    finishStage(table, &table->stop);
+    if (processingStarted == true) {
+        pthread_join(processingThread, NULL);
+    }
+    if (loadingStarted == true) {
+        pthread_join(loadingThread, NULL);
+    }
+
+    // The rest of input couldn't be loaded
+    if (err.error == false && input->failed == true) {
+        err.error = true;
+        err.message = "Nedostatek pameti pro nacitani vstupu.";
+    }
+
+    pthread_cond_destroy(&table->progress);
+    pthread_mutex_destroy(&table->lock);
+
+    for (int i = 0; i < table->numberOfChunks; i++) {
+        free(table->chunks[i].buffer);
+        closeOutput(&table->chunks[i].output);
+    }
+
+    if (err.error == false) {
+        err = finishTable(output, functions, &table->layout, table->numberOfRows, stats);
+    }
+    freeTableLayout(&table->layout);
+    free(table);
+
+    return err;
+}
+
+/**
+ * Loads chunks to free places of the ring until the end of input (loading stage's main function)
+ * @param pipelineTable Processed table (PipelineTable)
+ * @return Nothing (NULL)
+ */
+void *loadPipelineChunks(void *pipelineTable) {
+    PipelineTable *table = pipelineTable;
+
+    int nextRowNumber = 1;
+    int loaded = 0;
+    bool end = false;
+    while (end == false && waitForChunks(table, &table->written, loaded - table->numberOfChunks + 1,
+                                         &table->stop) == true) {
+        Chunk *chunk = &table->chunks[loaded % table->numberOfChunks];
+        if (loadChunk(chunk, table->input, nextRowNumber) == false) {
+            break;
+        }
+
+        nextRowNumber += countChunkRows(chunk);
+        end = chunk->input.partial == false;
+        advanceStage(table, &table->loaded, ++loaded);
+    }
+
+    // Number of rows is read after the thread is joined
+    table->numberOfRows = nextRowNumber - 1;
+    finishStage(table, &table->loadingFinished);
+
+    return NULL;
+}
+
+/**
+ * Processes loaded chunks in their order until the loading stage finishes (processing stage's main function)
+ * @param pipelineTable Processed table (PipelineTable)
+ * @return Nothing (NULL)
+ */
+void *processPipelineChunks(void *pipelineTable) {
+    PipelineTable *table = pipelineTable;
+
+    int processed = 0;
+    bool failed = false;
+    while (failed == false && waitForChunks(table, &table->loaded, processed + 1,
+                                            &table->loadingFinished) == true) {
+        Chunk *chunk = &table->chunks[processed % table->numberOfChunks];
+
+        // There is only one processing thread, so the layout is prepared by the first row as usual
+        processChunk(chunk, table->functions, table->delimiters, &table->layout,
+                     table->stats != NULL ? &chunk->stats : NULL);
+
+        // Chunk can be reused once it's been counted as processed, so its result is checked before
+        failed = chunk->err.error == true || __atomic_load_n(&table->stop, __ATOMIC_ACQUIRE) == true;
+        advanceStage(table, &table->processed, ++processed);
+    }
+
+    finishStage(table, &table->processingFinished);
+
+    return NULL;
+}
+
+/**
+ * Waits until the counter of the previous stage reaches the count (or until the previous stage finishes)
+ * @param table Processed table
+ * @param counter Counter of the previous stage (it's changed by the previous stage only, see advanceStage())
+ * @param count Required value of the counter
+ * @param finished Flag of the previous stage's finish (see finishStage())
+ * @return Has the counter reached the count? If false, the previous stage has finished before.
+ */
+bool waitForChunks(PipelineTable *table, const int *counter, int count, const bool *finished) {
+    // Counters are mostly ahead (stages are waiting rarely), so the lock is used only for real waiting
+    if (__atomic_load_n(counter, __ATOMIC_ACQUIRE) >= count) {
+        return true;
+    }
+
+    pthread_mutex_lock(&table->lock);
+
+    // The previous stage must see the waiting stage before it's checked (or the stage must see the new counter)
+    __atomic_add_fetch(&table->waiting, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(counter, __ATOMIC_SEQ_CST) < count &&
+           __atomic_load_n(finished, __ATOMIC_SEQ_CST) == false) {
+        pthread_cond_wait(&table->progress, &table->lock);
+    }
+    __atomic_sub_fetch(&table->waiting, 1, __ATOMIC_SEQ_CST);
+
+    pthread_mutex_unlock(&table->lock);
+
+    return __atomic_load_n(counter, __ATOMIC_ACQUIRE) >= count;
+}
+
+/**
+ * Moves counter of a stage (chunks passed by the stage are available for the next stage)
+ * @param table Processed table
+ * @param counter Counter of the stage
+ * @param count New value of the counter
+ */
+void advanceStage(PipelineTable *table, int *counter, int count) {
+    __atomic_store_n(counter, count, __ATOMIC_SEQ_CST);
+
+    // Lock is needed only for waking up stages waiting in waitForChunks()
+    if (__atomic_load_n(&table->waiting, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&table->lock);
+        pthread_cond_broadcast(&table->progress);
+        pthread_mutex_unlock(&table->lock);
+    }
+}
+
+/**
+ * Marks a stage as finished (stages waiting for it stop waiting)
+ * @param table Processed table
+ * @param finished Flag of the stage's finish
+ */
+void finishStage(PipelineTable *table, bool *finished) {
+    __atomic_store_n(finished, true, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&table->waiting, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&table->lock);
+        pthread_cond_broadcast(&table->progress);
+        pthread_mutex_unlock(&table->lock);
+    }
+}
+
+/**
+ * Validates all rows of mapped input before processing by more threads (so invalid table fails before any output)
+ * @param input Mapped input with table's rows (number of columns of its rows is set if they're valid)
+ * @param delimiters Used delimiters
+ * @return Error information
+ */
+ErrorInfo validateTable(Input *input, const Delimiters *delimiters) {
+    ErrorInfo err = {false};
+
+    // Every validating thread has at least one block of input
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t blocks = input->size / INPUT_BLOCK_SIZE + 1;
+    int numberOfParts = processors < 1 ? 1 : processors > MAX_THREADS ? MAX_THREADS : (int)processors;
+    if ((size_t)numberOfParts > blocks) {
+        numberOfParts = (int)blocks;
+    }
+
+    // Parts end after \n, so every row is in one part only
+    ValidationPart parts[MAX_THREADS];
+    size_t start = 0;
+    for (int i = 0; i < numberOfParts; i++) {
+        size_t end = input->size / numberOfParts * (i + 1);
+        if (i == numberOfParts - 1 || end <= start) {
+            end = i == numberOfParts - 1 ? input->size : start;
+        } else {
+            const char *newLine = memchr(&input->buffer[end - 1], '\n', input->size - end + 1);
+            end = newLine != NULL ? (size_t)(newLine - input->buffer) + 1 : input->size;
+        }
+
+        parts[i].data = &input->buffer[start];
+        parts[i].size = end - start;
+        parts[i].delimiters = delimiters;
+        parts[i].numberOfCells = 0;
+        parts[i].valid = true;
+        start = end;
+    }
+
+    // The first part is validated by the calling thread (and parts whose thread couldn't be started, too)
+    pthread_t threads[MAX_THREADS];
+    bool started[MAX_THREADS] = {false};
+    for (int i = 1; i < numberOfParts; i++) {
+        started[i] = pthread_create(&threads[i], NULL, validatePart, &parts[i]) == 0;
+    }
+    for (int i = 0; i < numberOfParts; i++) {
+        if (started[i] == true) {
+            pthread_join(threads[i], NULL);
+        } else {
+            validatePart(&parts[i]);
+        }
+    }
+
+    int numberOfColumns = 0;
+    for (int i = 0; i < numberOfParts; i++) {
+        if (numberOfColumns == 0) {
+            numberOfColumns = parts[i].numberOfCells;
+        }
+
+        if (parts[i].valid == false || (parts[i].numberOfCells != 0 && parts[i].numberOfCells != numberOfColumns)) {
+            err.error = true;
+            err.message = "Kazdy radek musi mit stejny pocet sloupcu.";
+
+            return err;
+        }
+    }
+
+    input->numberOfColumns = numberOfColumns;
+
+    return err;
+}
+
+/**
+ * Validates rows of the part of input (validating thread's main function)
+ * @param validationPart Validated part (ValidationPart)
+ * @return Nothing (NULL)
+ */
+void *validatePart(void *validationPart) {
+    ValidationPart *part = validationPart;
+
+#ifdef X86_SIMD
+    // SIMD kernel doesn't handle \n used as delimiter
+    const Delimiters *delimiters = part->delimiters;
+    if (delimiters->numberOfOthers <= MAX_SIMD_DELIMITERS && delimiters->classes['\n'] == NEW_LINE_CHAR) {
+        validatePartSse2(part);
+
+        return NULL;
+    }
+#endif
+
+    validatePartScalar(part, 0, 1);
+
+    return NULL;
+}
+
+/**
+ * Validates rows of the part of input char by char (reference kernel for validatePart())
+ * @param part Validated part
+ * @param start Position of the first char to validate (previous chars have already been validated)
+ * @param cells Number of cells of the actual row before the start
+ */
+void validatePartScalar(ValidationPart *part, size_t start, int cells) {
+    const unsigned char *classes = part->delimiters->classes;
+    for (size_t i = start; i < part->size; i++) {
+        unsigned char class = classes[(unsigned char) part->data[i]];
+
+        if (part->data[i] == '\n') {
+            // \n used as other delimiter is a delimiter even at the end of the row (see indexRowCells())
+            if (addPartRow(part, cells + (class == DELIMITER_CHAR)) == false) {
+                return;
+            }
+
+            cells = 1;
+        } else if (class == DELIMITER_CHAR || class == MAIN_DELIMITER_CHAR) {
+            cells++;
+        }
+    }
+
+    // The last row of input doesn't have to end with \n
+    if (part->size > 0 && part->data[part->size - 1] != '\n') {
+        addPartRow(part, cells);
+    }
+}
+
+#ifdef X86_SIMD
+/**
+ * Validates rows of the part of input by blocks of 16 chars (SSE2 kernel for validatePart(), \n mustn't be a delimiter)
+ * @param part Validated part
+ */
+__attribute__((target("sse2")))
+void validatePartSse2(ValidationPart *part) {
+    const Delimiters *delimiters = part->delimiters;
+    const __m128i newLine = _mm_set1_epi8('\n');
+    const __m128i mainDelimiter = _mm_set1_epi8(delimiters->main);
+    __m128i otherDelimiters[MAX_SIMD_DELIMITERS];
+    for (int i = 0; i < delimiters->numberOfOthers; i++) {
+        otherDelimiters[i] = _mm_set1_epi8(delimiters->others[i]);
+    }
+
+    int cells = 1;
+    size_t i = 0;
+    for (; i + 16 <= part->size; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *) &part->data[i]);
+        __m128i found = _mm_cmpeq_epi8(block, mainDelimiter);
+        for (int j = 0; j < delimiters->numberOfOthers; j++) {
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(block, otherDelimiters[j]));
+        }
+
+        unsigned int delimiterMask = _mm_movemask_epi8(found);
+        unsigned int newLineMask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, newLine));
+        while (newLineMask != 0) {
+            // Delimiters before the first \n belong to the actual row
+            unsigned int before = (newLineMask & (0U - newLineMask)) - 1;
+            if (addPartRow(part, cells + __builtin_popcount(delimiterMask & before)) == false) {
+                return;
+            }
+
+            cells = 1;
+            delimiterMask &= ~(before << 1 | 1);
+            newLineMask &= newLineMask - 1;
+        }
+
+        cells += __builtin_popcount(delimiterMask);
+    }
+
+    // Rest of data (shorter than one block)
+    validatePartScalar(part, i, cells);
+}
+#endif
+
+/**
+ * Checks number of cells of the next row of the part
+ * @param part Validated part
+ * @param cells Number of cells of the row
+ * @return Is the row valid? (it has the same number of cells as the part's first row)
+ */
+bool addPartRow(ValidationPart *part, int cells) {
+    if (part->numberOfCells == 0) {
+        part->numberOfCells = cells;
+    }
+
+    part->valid = cells == part->numberOfCells;
+
+    return part->valid;
+}
+
+/************************************************************************************************************Row index*/
+/**
+ * Opens the row index of the input (the saved one is loaded if it's for the same input, otherwise it's built and saved)
+ * @param index Row index to open
+ * @param input Mapped input file (it's marked as indexed)
+ * @param delimiters Used delimiters
+ * @param path Path of the index file
+ * @return Error information
+ */
+ErrorInfo openRowIndex(RowIndex *index, Input *input, const Delimiters *delimiters, const char *path) {
+    ErrorInfo err = {false};
+
+    IndexHeader header;
+    if (prepareIndexHeader(&header, input, delimiters) == false) {
+        err.error = true;
+        err.message = "Nepodarilo se zjistit informace o vstupnim souboru.";
+
+        return err;
+    }
+
+    if (loadRowIndex(index, &header, path) == false) {
+        if ((err = buildRowIndex(index, input, delimiters)).error == true) {
+            return err;
+        }
+
+        if (saveRowIndex(index, &header, path) == false) {
+            err.error = true;
+            err.message = "Nepodarilo se zapsat index radku.";
+
+            return err;
+        }
+    }
+
+    // Rows of indexed input needn't be validated again
+    input->numberOfColumns = index->numberOfColumns;
+    input->index = index;
+
+    return err;
+}
+
+/**
+ * Prepares header of the row index file for the input (fields describing the index are set by saveRowIndex())
+ * @param header Header to prepare
+ * @param input Mapped input file
+ * @param delimiters Used delimiters
+ * @return Was it successful? If false, information about the input file aren't available.
+ */
+bool prepareIndexHeader(IndexHeader *header, const Input *input, const Delimiters *delimiters) {
+    struct stat info;
+    if (fstat(input->fd, &info) != 0) {
+        return false;
+    }
+
+    // Unused bytes are zeroed as they are written to the file, too
+    memset(header, 0, sizeof(IndexHeader));
+    memcpy(header->magic, INDEX_MAGIC, sizeof(header->magic));
+    header->step = INDEX_STEP;
+    header->inputSize = info.st_size;
+    header->modified = info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+    memcpy(header->classes, delimiters->classes, sizeof(header->classes));
+
+    return true;
+}
+
+/**
+ * Loads saved row index
+ * @param index Row index to load
+ * @param header Expected header of the index file (see prepareIndexHeader())
+ * @param path Path of the index file
+ * @return Was it successful? If false, the index file doesn't exist or it's for other input or delimiters.
+ */
+bool loadRowIndex(RowIndex *index, const IndexHeader *header, const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+
+    IndexHeader saved;
+    bool loaded = fread(&saved, sizeof(saved), 1, file) == 1 &&
+                  memcmp(saved.magic, header->magic, sizeof(saved.magic)) == 0 && saved.step == header->step &&
+                  saved.inputSize == header->inputSize && saved.modified == header->modified &&
+                  memcmp(saved.classes, header->classes, sizeof(saved.classes)) == 0 &&
+                  saved.numberOfRows > 0 && saved.numberOfColumns > 0 &&
+                  saved.numberOfOffsets == (size_t)(saved.numberOfRows - 1) / INDEX_STEP + 1;
+    if (loaded == true) {
+        index->offsets = malloc(saved.numberOfOffsets * sizeof(size_t));
+        loaded = index->offsets != NULL &&
+                 fread(index->offsets, sizeof(size_t), saved.numberOfOffsets, file) == saved.numberOfOffsets;
+    }
+    fclose(file);
+
+    if (loaded == true) {
+        index->numberOfOffsets = saved.numberOfOffsets;
+        index->numberOfRows = saved.numberOfRows;
+        index->numberOfColumns = saved.numberOfColumns;
+
+        // Damaged index is built again
+        loaded = getIndexChecksum(index) == saved.checksum;
+    }
+
+    if (loaded == false) {
+        freeRowIndex(index);
+    }
+
+    return loaded;
+}
+
+/**
+ * Builds row index of the input (only valid table is indexed)
+ * @param index Row index to build
+ * @param input Mapped input file
+ * @param delimiters Used delimiters
+ * @return Error information
+ */
+ErrorInfo buildRowIndex(RowIndex *index, Input *input, const Delimiters *delimiters) {
+    ErrorInfo err = {false};
+
+    // Index replaces checking of numbers of columns, so all rows are validated first
+    if (input->numberOfColumns == 0 && (err = validateTable(input, delimiters)).error == true) {
+        return err;
+    }
+
+    size_t capacity = 0;
+    index->numberOfOffsets = 0;
+    index->numberOfRows = 0;
+    index->numberOfColumns = input->numberOfColumns;
+    for (size_t position = 0; position < input->size; index->numberOfRows++) {
+        if (index->numberOfRows % INDEX_STEP == 0) {
+            if (index->numberOfOffsets == capacity) {
+                capacity = capacity == 0 ? INDEX_STEP : capacity * 2;
+                size_t *offsets = realloc(index->offsets, capacity * sizeof(size_t));
+                if (offsets == NULL) {
+                    freeRowIndex(index);
+                    err.error = true;
+                    err.message = "Nedostatek pameti pro index radku.";
+
+                    return err;
+                }
+
+                index->offsets = offsets;
+            }
+
+            index->offsets[index->numberOfOffsets++] = position;
+        }
+
+        // The last row of input doesn't have to end with \n
+        const char *newLine = memchr(&input->buffer[position], '\n', input->size - position);
+        position = newLine != NULL ? (size_t)(newLine - input->buffer) + 1 : input->size;
+    }
+
+    return err;
+}
+
+/**
+ * Saves row index to the file (it's written to a temporary file first, so concurrent runs don't see partial index)
+ * @param index Built row index
+ * @param header Header of the index file (see prepareIndexHeader())
+ * @param path Path of the index file
+ * @return Was it successful?
+ */
+bool saveRowIndex(const RowIndex *index, IndexHeader *header, const char *path) {
+    header->numberOfRows = index->numberOfRows;
+    header->numberOfColumns = index->numberOfColumns;
+    header->numberOfOffsets = index->numberOfOffsets;
+    header->checksum = getIndexChecksum(index);
+
+    size_t size = strlen(path) + 32;
+    char *temporary = malloc(size);
+    if (temporary == NULL) {
+        return false;
+    }
+    snprintf(temporary, size, "%s.%ld.tmp", path, (long) getpid());
+
+    FILE *file = fopen(temporary, "wb");
+    bool saved = file != NULL && fwrite(header, sizeof(IndexHeader), 1, file) == 1 &&
+                 fwrite(index->offsets, sizeof(size_t), index->numberOfOffsets, file) == index->numberOfOffsets;
+    if (file != NULL) {
+        saved = fclose(file) == 0 && saved;
+    }
+
+    saved = saved && rename(temporary, path) == 0;
+    if (saved == false) {
+        remove(temporary);
+    }
+    free(temporary);
+
+    return saved;
+}
+
+/**
+ * Releases memory of the row index
+ * @param index Row index to free
+ */
+void freeRowIndex(RowIndex *index) {
+    free(index->offsets);
+    index->offsets = NULL;
+    index->numberOfOffsets = 0;
+}
+
+/**
+ * Computes checksum of offsets of the row index (FNV-1a)
+ * @param index Row index
+ * @return Checksum of the offsets
+ */
+unsigned long long getIndexChecksum(const RowIndex *index) {
+    const unsigned char *bytes = (const unsigned char *) index->offsets;
+    size_t size = index->numberOfOffsets * sizeof(size_t);
+
+    unsigned long long checksum = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        checksum = (checksum ^ bytes[i]) * 1099511628211ULL;
+    }
+
+    return checksum;
+}
+
+/**
+ * Finds start of the row by the row index (only rows after the nearest indexed row are searched)
+ * @param index Row index
+ * @param input Indexed input
+ * @param number Number of the row (it must exist)
+ * @return Offset of the row in the input
+ */
+size_t getRowOffset(const RowIndex *index, const Input *input, int number) {
+    size_t offset = index->offsets[(number - 1) / INDEX_STEP];
+    for (int i = (number - 1) % INDEX_STEP; i > 0; i--) {
+        const char *newLine = memchr(&input->buffer[offset], '\n', input->size - offset);
+        offset = (size_t)(newLine - input->buffer) + 1;
+    }
+
+    return offset;
+}
+
+/**
+ * Finds the next row affected by some function (other rows are written as they are)
+ * @param functions Parsed and verified functions
+ * @param index Row index of the input
+ * @param number Number of the first row to check
+ * @return Number of the first affected row from the given one (number of rows + 1 if there isn't any)
+ */
+int getNextAffectedRow(const Function *functions, const RowIndex *index, int number) {
+    int next = index->numberOfRows + 1;
+    for (int i = 0; functions[i].type != NO_FUNCTION; i++) {
+        const Function *function = &functions[i];
+        const SelectFunction *selection = &function->selectFunction;
+
+        // Column editing functions and data processing functions without rows selection affect all rows
+        int from = 1;
+        int to = index->numberOfRows;
+        switch (function->type) {
+            case AROW:
+                continue;
+            case IROW:
+            case DROW:
+                from = to = function->params[0];
+                break;
+            case DROWS:
+                from = function->params[0];
+                to = function->params[1];
+                break;
+            case ICOL:
+            case ACOL:
+            case DCOL:
+            case DCOLS:
+                break;
+            default:
+                // Rows are selected the same way as by acceptsSelection()
+                if (selection->type != ROWS) {
+                    break;
+                } else if (selection->params[0] == LAST_ROW_NUMBER && selection->params[1] == LAST_ROW_NUMBER) {
+                    from = index->numberOfRows;
+                } else if (selection->params[0] != NO_SELECTION && selection->params[1] != LAST_ROW_NUMBER) {
+                    from = selection->params[0];
+                    to = selection->params[1];
+                } else if (selection->params[0] != NO_SELECTION) {
+                    from = selection->params[0];
+                } else {
+                    continue;
+                }
+        }
+
+        if (to >= number && (from > number ? from : number) < next) {
+            next = from > number ? from : number;
+        }
+    }
+
+    return next;
+}
+
+/**
+ * Copies rows not affected by any function from indexed input to output at once (rows are validated by the index)
+ * @param input Indexed input (the only delimiter is the main one, rows are copied as they are)
+ * @param output Output for the rows
+ * @param row Row with number of the last processed row (it gets number of the last copied one)
+ * @param functions Parsed and verified functions
+ */
+void copyUnaffectedRows(Input *input, Output *output, Row *row, const Function *functions) {
+    const RowIndex *index = input->index;
+    int next = getNextAffectedRow(functions, index, row->number + 1);
+    if (next == row->number + 1) {
+        return;
+    }
+
+    // Output buffer has limited size, so long part of input is written in blocks (too big blocks are written directly)
+    size_t end = next > index->numberOfRows ? input->size : getRowOffset(index, input, next);
+    for (size_t position = input->position; position < end; position += OUTPUT_BUFFER_SIZE) {
+        writeOutput(output, &input->buffer[position],
+                    (int)(end - position < OUTPUT_BUFFER_SIZE ? end - position : OUTPUT_BUFFER_SIZE));
+    }
+    if (output->lineBuffered == true) {
+        flushOutput(output);
+    }
+
+    input->position = end;
+    row->number = next - 1;
+    row->last = next > index->numberOfRows;
+}
+
+/****************************************************************************************************Branch processing*/
+/**
+ * Parses arguments into branches of functions (every --tee FILE starts a new branch, the first one has standard output)
+ * @param branches Array for parsed branches (MAX_BRANCHES items)
+ * @param numberOfBranches Number of parsed branches
+ * @param args Program input arguments (after options)
+ * @return Error information
+ */
+ErrorInfo parseBranches(Branch *branches, int *numberOfBranches, const InputArguments *args) {
+    ErrorInfo err = {false};
+
+    InputArguments branchArgs = *args;
+    const char *path = NULL;
+    for (*numberOfBranches = 0; true; (*numberOfBranches)++) {
+        if (*numberOfBranches == MAX_BRANCHES) {
+            err.error = true;
+            err.message = "Byl prekrocen maximalni pocet vystupu.";
+
+            return err;
+        }
+
+        // Functions of the branch end with the next --tee
+        branchArgs.size = branchArgs.skipped;
+        while (branchArgs.size < args->size && !(streq(args->data[branchArgs.size], "--tee"))) {
+            branchArgs.size++;
+        }
+
+        Branch *branch = &branches[*numberOfBranches];
+        branch->path = path;
+        branch->output = NULL;
+        if ((err = parseInputArguments(branch->functions, &branchArgs)).error == true ||
+            (err = verifyFunctions(branch->functions)).error == true) {
+            return err;
+        }
+
+        if (branchArgs.size == args->size) {
+            break;
+        } else if (branchArgs.size + 1 == args->size) {
+            err.error = true;
+            err.message = "Chybi nazev vystupniho souboru.";
+
+            return err;
+        }
+
+        path = args->data[branchArgs.size + 1];
+        branchArgs.skipped = branchArgs.size + 2;
+    }
+    (*numberOfBranches)++;
+
+    return err;
+}
+
+/**
+ * Opens output files of branches (the first branch has already got standard output; files with GZIP_SUFFIX are
+ * compressed)
+ * @param branches Parsed branches
+ * @param numberOfBranches Number of the branches
+ * @return Was it successful? If false, some file can't be opened (or there isn't enough memory); no output is open.
+ */
+bool openBranchOutputs(Branch *branches, int numberOfBranches) {
+    for (int i = 1; i < numberOfBranches; i++) {
+        Branch *branch = &branches[i];
+        int fd = open(branch->path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (fd < 0 || (branch->output = malloc(sizeof(Output))) == NULL ||
+            openOutput(branch->output, fd, false) == false ||
+            (isCompressedPath(branch->path) == true && openCompressor(branch->output) == false)) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            if (branch->output != NULL) {
+                closeOutput(branch->output);
+            }
+            free(branch->output);
+            branch->output = NULL;
+            closeBranchOutputs(branches, i);
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Writes the rest of data to output files of branches and closes them
+ * @param branches Branches with open outputs
+ * @param numberOfBranches Number of the branches
+ * @return Was it successful? It's false if any write to the files failed.
+ */
+bool closeBranchOutputs(Branch *branches, int numberOfBranches) {
+    bool written = true;
+    for (int i = 1; i < numberOfBranches; i++) {
+        Output *output = branches[i].output;
+        written = finishOutput(output) == true && written == true;
+        written = close(output->fd) == 0 && written == true;
+        closeOutput(output);
+        free(output);
+        branches[i].output = NULL;
+    }
+
+    return written;
+}
+
+/**
+ * Processes all rows of the table by more branches (every row is loaded, verified and indexed only once for all)
+ * @param input Input with table
+ * @param branches Branches with open outputs (see openBranchOutputs())
+ * @param numberOfBranches Number of the branches
+ * @param delimiters Used delimiters
+ * @return Error information (rows processed before an error are in outputs of all branches)
+ */
+ErrorInfo processBranches(Input *input, Branch *branches, int numberOfBranches, const Delimiters *delimiters) {
+    ErrorInfo err = {false};
+
+    for (int i = 0; i < numberOfBranches; i++) {
+        branches[i].layout = (TableLayout) {NULL}; // It's prepared by the first row of the table
+    }
+
+    char delimiter = delimiters->main;
+    Arena arena = {NULL};
+    Row row = {.size = 0, .number = 0, .last = false, .arena = &arena};
+    int numberOfColumns = 0;
+    while (err.error == false) {
+        resetArena(&arena);
+        if (loadRow(&row, input) == false) {
+            break;
+        }
+
+        if ((err = verifyRow(&row, delimiters)).error == true) {
+            break;
+        }
+
+        if (row.number == 1) {
+            numberOfColumns = row.numberOfCells;
+        } else if (row.numberOfCells != numberOfColumns) {
+            err.error = true;
+            err.message = "Kazdy radek musi mit stejny pocet sloupcu.";
+            break;
+        }
+
+        // Every branch changes its own view of the row (data are shared until the branch changes them)
+        for (int i = 0; i < numberOfBranches && err.error == false; i++) {
+            Branch *branch = &branches[i];
+            if (row.number == 1) {
+                err = prepareTableLayout(&branch->layout, branch->functions, numberOfColumns, delimiter);
+                if (err.error == true) {
+                    break;
+                }
+            }
+
+            Row view;
+            prepareRowView(&view, &row);
+            err = applyFunctions(&view, branch->functions, &branch->layout, false, delimiter, branch->output, NULL,
+                                 false);
+        }
+    }
+    freeArena(&arena);
+
+    // The rest of input couldn't be loaded
+    if (err.error == false && input->failed == true) {
+        err.error = true;
+        err.message = "Nedostatek pameti pro nacitani vstupu.";
+    }
+
+    for (int i = 0; i < numberOfBranches; i++) {
+        if (err.error == false) {
+            err = finishTable(branches[i].output, branches[i].functions, &branches[i].layout, row.number, NULL);
+        }
+        freeTableLayout(&branches[i].layout);
+    }
+
+    return err;
+}
+
+/**
+ * Prepares copy-on-write view of the verified row (changes of the view don't change the row)
+ * @param view View to prepare (it gets its own index of cells, data are moved to its storage when they change)
+ * @param row Verified row with indexed cells
+ */
+void prepareRowView(Row *view, const Row *row) {
+    *view = *row;
+    view->readOnly = true;
+    view->storage = NULL;
+    view->storageCapacity = 0;
+
+    view->cells = NULL;
+    view->cellsCapacity = 0;
+    if (reserveRowCells(view, row->numberOfCells) == true) {
+        memcpy(view->cells, row->cells, (row->numberOfCells + 1) * sizeof(int));
+    }
+}
+
+/**********************************************************************************************************Compression*/
+/**
+ * Checks if the file is compressed by gzip (by its suffix)
+ * @param path Path to the file
+ * @return Has the path GZIP_SUFFIX?
+ */
+bool isCompressedPath(const char *path) {
+    size_t length = strlen(path);
+    size_t suffixLength = strlen(GZIP_SUFFIX);
+
+    return length > suffixLength && streq(&path[length - suffixLength], GZIP_SUFFIX);
+}
+
+#ifdef ENABLE_ZLIB
+/**
+ * Starts decompression of the input in its own thread (the input is read through readDecompressed())
+ * @param input Opened input with compressed data
+ * @return Was it successful? If false, there isn't enough memory (or the thread can't be started).
+ */
+bool openDecompressor(Input *input) {
+    Decompressor *decompressor = calloc(1, sizeof(Decompressor));
+    if (decompressor == NULL) {
+        return false;
+    }
+
+    bool prepared = (decompressor->compressed = malloc(INPUT_BLOCK_SIZE)) != NULL;
+    for (int i = 0; i < DECOMPRESSED_BLOCKS; i++) {
+        prepared = prepared == true && (decompressor->blocks[i] = malloc(INPUT_BLOCK_SIZE)) != NULL;
+    }
+
+    // Additional 16 of window bits means gzip format
+    if (prepared == false || inflateInit2(&decompressor->stream, MAX_WBITS + 16) != Z_OK) {
+        freeDecompressor(decompressor);
+
+        return false;
+    }
+
+    decompressor->fd = input->fd;
+    pthread_mutex_init(&decompressor->lock, NULL);
+    pthread_cond_init(&decompressor->changed, NULL);
+    if (pthread_create(&decompressor->thread, NULL, decompressInput, decompressor) != 0) {
+        pthread_cond_destroy(&decompressor->changed);
+        pthread_mutex_destroy(&decompressor->lock);
+        inflateEnd(&decompressor->stream);
+        freeDecompressor(decompressor);
+
+        return false;
+    }
+
+    input->decompressor = decompressor;
+
+    return true;
+}
+
+/**
+ * Stops decompression of the input and releases its resources
+ * @param input Input with decompression (or without it)
+ */
+void closeDecompressor(Input *input) {
+    Decompressor *decompressor = input->decompressor;
+    if (decompressor == NULL) {
+        return;
+    }
+
+    // Thread can wait for a free block or for compressed data (reading of them can be cancelled only)
+    pthread_mutex_lock(&decompressor->lock);
+    decompressor->stopped = true;
+    pthread_cond_broadcast(&decompressor->changed);
+    pthread_mutex_unlock(&decompressor->lock);
+    pthread_cancel(decompressor->thread);
+    pthread_join(decompressor->thread, NULL);
+
+    pthread_cond_destroy(&decompressor->changed);
+    pthread_mutex_destroy(&decompressor->lock);
+    inflateEnd(&decompressor->stream);
+    freeDecompressor(decompressor);
+    input->decompressor = NULL;
+}
+
+/**
+ * Frees memory of the decompressor
+ * @param decompressor Decompressor to free (its buffers can be partly allocated)
+ */
+void freeDecompressor(Decompressor *decompressor) {
+    free(decompressor->compressed);
+    for (int i = 0; i < DECOMPRESSED_BLOCKS; i++) {
+        free(decompressor->blocks[i]);
+    }
+    free(decompressor);
+}
+
+/**
+ * Decompresses the whole input into the ring of blocks (thread function, see openDecompressor())
+ * @param data Decompressor of the input
+ * @return Nothing (NULL)
+ */
+void *decompressInput(void *data) {
+    Decompressor *decompressor = data;
+
+    // Thread is cancelled only while it's reading compressed data (see decompressBlock())
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+    bool finished = false;
+    while (finished == false) {
+        // All blocks can be waiting for reading
+        pthread_mutex_lock(&decompressor->lock);
+        while (decompressor->count == DECOMPRESSED_BLOCKS && decompressor->stopped == false) {
+            pthread_cond_wait(&decompressor->changed, &decompressor->lock);
+        }
+        bool stopped = decompressor->stopped;
+        int next = (decompressor->first + decompressor->count) % DECOMPRESSED_BLOCKS;
+        pthread_mutex_unlock(&decompressor->lock);
+
+        if (stopped == true) {
+            break;
+        }
+
+        // Free block isn't used by reading, so it's filled without the lock
+        size_t size = decompressBlock(decompressor, decompressor->blocks[next], &finished);
+
+        pthread_mutex_lock(&decompressor->lock);
+        decompressor->sizes[next] = size;
+        if (size > 0) {
+            decompressor->count++;
+        }
+        decompressor->finished = finished;
+        pthread_cond_broadcast(&decompressor->changed);
+        pthread_mutex_unlock(&decompressor->lock);
+    }
+
+    return NULL;
+}
+
+/**
+ * Decompresses the next block of the input
+ * @param decompressor Decompressor of the input
+ * @param block Block for decompressed data (INPUT_BLOCK_SIZE bytes)
+ * @param finished Has the whole input been decompressed? (or has decompression failed, see failed)
+ * @return Number of decompressed bytes in the block
+ */
+size_t decompressBlock(Decompressor *decompressor, char *block, bool *finished) {
+    z_stream *stream = &decompressor->stream;
+    stream->next_out = (unsigned char *)block;
+    stream->avail_out = INPUT_BLOCK_SIZE;
+
+    while (stream->avail_out > 0) {
+        if (stream->avail_in == 0) {
+            // Decompressed data are passed to reading before waiting for more compressed data (they can come slowly)
+            if (stream->avail_out < INPUT_BLOCK_SIZE) {
+                break;
+            }
+
+            ssize_t loaded;
+            pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+            do {
+                loaded = read(decompressor->fd, decompressor->compressed, INPUT_BLOCK_SIZE);
+            } while (loaded < 0 && errno == EINTR);
+            pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+            // Compressed input can't end inside of a gzip member
+            if (loaded <= 0) {
+                decompressor->failed = loaded < 0 || decompressor->ended == false;
+                *finished = true;
+                break;
+            }
+
+            stream->next_in = decompressor->compressed;
+            stream->avail_in = (unsigned int)loaded;
+        }
+
+        // Concatenated gzip members are one input (as in gzip)
+        unsigned int available = stream->avail_in;
+        int result = inflate(stream, Z_NO_FLUSH);
+        if (result == Z_STREAM_END) {
+            decompressor->ended = true;
+            inflateReset(stream);
+        } else if (result == Z_OK || result == Z_BUF_ERROR) {
+            decompressor->ended = decompressor->ended == true && stream->avail_in == available;
+        } else {
+            decompressor->failed = true;
+            *finished = true;
+            break;
+        }
+    }
+
+    return INPUT_BLOCK_SIZE - stream->avail_out;
+}
+
+/**
+ * Reads decompressed data of the input (it waits for decompressing thread if no block is ready)
+ * @param input Input with decompression (corrupted is set at the end of failed decompression)
+ * @param buffer Buffer for the data
+ * @param size Size of the buffer
+ * @return Number of read bytes (0 at the end of the input)
+ */
+size_t readDecompressed(Input *input, char *buffer, size_t size) {
+    Decompressor *decompressor = input->decompressor;
+
+    pthread_mutex_lock(&decompressor->lock);
+    while (decompressor->count == 0 && decompressor->finished == false) {
+        pthread_cond_wait(&decompressor->changed, &decompressor->lock);
+    }
+    bool ready = decompressor->count > 0;
+    int first = decompressor->first;
+    input->corrupted = ready == false && decompressor->failed == true;
+    pthread_mutex_unlock(&decompressor->lock);
+
+    if (ready == false) {
+        return 0;
+    }
+
+    // Ready block isn't changed until it's read whole
+    size_t rest = decompressor->sizes[first] - decompressor->position;
+    if (size > rest) {
+        size = rest;
+    }
+    memcpy(buffer, &decompressor->blocks[first][decompressor->position], size);
+    decompressor->position += size;
+
+    if (decompressor->position == decompressor->sizes[first]) {
+        decompressor->position = 0;
+
+        pthread_mutex_lock(&decompressor->lock);
+        decompressor->first = (first + 1) % DECOMPRESSED_BLOCKS;
+        decompressor->count--;
+        pthread_cond_signal(&decompressor->changed);
+        pthread_mutex_unlock(&decompressor->lock);
+    }
+
+    return size;
+}
+
+/**
+ * Starts gzip compression of the output (see compressOutput())
+ * @param output Opened output
+ * @return Was it successful? If false, there isn't enough memory.
+ */
+bool openCompressor(Output *output) {
+    Compressor *compressor = calloc(1, sizeof(Compressor));
+    if (compressor == NULL) {
+        return false;
+    }
+
+    // Additional 16 of window bits means gzip format
+    if ((compressor->buffer = malloc(OUTPUT_BUFFER_SIZE)) == NULL ||
+        deflateInit2(&compressor->stream, COMPRESSION_LEVEL, Z_DEFLATED, MAX_WBITS + 16, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        free(compressor->buffer);
+        free(compressor);
+
+        return false;
+    }
+
+    output->compressor = compressor;
+
+    return true;
+}
+
+/**
+ * Releases resources of compression of the output (data that haven't been finished are lost)
+ * @param output Output with compression (or without it)
+ */
+void closeCompressor(Output *output) {
+    Compressor *compressor = output->compressor;
+    if (compressor == NULL) {
+        return;
+    }
+
+    deflateEnd(&compressor->stream);
+    free(compressor->buffer);
+    free(compressor);
+    output->compressor = NULL;
+}
+
+/**
+ * Compresses data waiting in output buffer and writes produced compressed data
+ * @param output Output with compression
+ * @param finish Should be compressed data ended? (see finishOutput())
+ */
+void compressOutput(Output *output, bool finish) {
+    Compressor *compressor = output->compressor;
+    z_stream *stream = &compressor->stream;
+    stream->next_in = (unsigned char *)output->buffer;
+    stream->avail_in = (unsigned int)output->size;
+
+    // Compression can produce more data than its buffer takes
+    int result;
+    do {
+        stream->next_out = compressor->buffer;
+        stream->avail_out = OUTPUT_BUFFER_SIZE;
+        result = deflate(stream, finish == true ? Z_FINISH : Z_NO_FLUSH);
+        writeOutputData(output, (const char *)compressor->buffer, OUTPUT_BUFFER_SIZE - stream->avail_out);
+    } while (output->failed == false && result != Z_STREAM_ERROR &&
+             (stream->avail_out == 0 || (finish == true && result != Z_STREAM_END)));
+}
+#else
+/**
+ * Starts decompression of the input (it isn't supported without zlib)
+ * @param input Opened input with compressed data
+ * @return Was it successful? It's always false.
+ */
+bool openDecompressor(Input *input) {
+    (void)input;
+
+    return false;
+}
+
+/**
+ * Stops decompression of the input (there isn't any without zlib)
+ * @param input Input without decompression
+ */
+void closeDecompressor(Input *input) {
+    (void)input;
+}
+
+/**
+ * Reads decompressed data of the input (there aren't any without zlib)
+ * @param input Input without decompression
+ * @param buffer Buffer for the data
+ * @param size Size of the buffer
+ * @return Number of read bytes (always 0)
+ */
+size_t readDecompressed(Input *input, char *buffer, size_t size) {
+    (void)input;
+    (void)buffer;
+    (void)size;
+
+    return 0;
+}
+
+/**
+ * Starts compression of the output (it isn't supported without zlib)
+ * @param output Opened output
+ * @return Was it successful? It's always false.
+ */
+bool openCompressor(Output *output) {
+    (void)output;
+
+    return false;
+}
+
+/**
+ * Releases resources of compression of the output (there isn't any without zlib)
+ * @param output Output without compression
+ */
+void closeCompressor(Output *output) {
+    (void)output;
+}
+
+/**
+ * Compresses data waiting in output buffer (there isn't any compression without zlib)
+ * @param output Output without compression
+ * @param finish Should be compressed data ended?
+ */
+void compressOutput(Output *output, bool finish) {
+    (void)output;
+    (void)finish;
+}
+#endif
+
+/*****************************************************************************************************Batch processing*/
+/**
+ * Checks if rows can be processed in batches
+ * @param input Input with rows
+ * @param functions Parsed and verified functions to apply
+ * @return Can be rows processed in batches? Data processing function must be the only function (see verifyFunctions())
+ *         and the whole input must be in memory (rows of a batch are views into it).
+ */
+bool isBatchable(const Input *input, const Function *functions) {
+    return input->mapped == true && functions[0].type != NO_FUNCTION &&
+           functionDefinitions[functions[0].type].tableEditing == false;
+}
+
+/**
+ * Processes rows from input to output in batches (every stage is applied to the whole batch before the next one, see
+ * processRows() for processing of one row)
+ * @param input Input with rows (whole input must be in memory, see isBatchable())
+ * @param output Output for processed rows
+ * @param functions Parsed and verified functions to apply (only one data processing function)
+ * @param delimiters Used delimiters
+ * @param row Row for loading rows (with number of the row before the first one; it gets number of the last loaded one)
+ * @param layout Layout of output rows (it's prepared by the first row of the table)
+ * @param stats Statistics of processing (NULL if they aren't collected)
+ * @return Error information
+ */
+ErrorInfo processBatches(Input *input, Output *output, const Function *functions, const Delimiters *delimiters,
+                         Row *row, TableLayout *layout, Stats *stats) {
+    ErrorInfo err = {false};
+
+    Batch *batch = calloc(1, sizeof(Batch));
+    if (batch == NULL) {
+        err.error = true;
+        err.message = "Nedostatek pameti pro zpracovani radku.";
+
+        return err;
+    }
+
+    const Function *function = &functions[0];
+    bool end = false;
+    while (err.error == false && end == false) {
+        // Statistics need sizes of all rows and other delimiters must be unified, so unaffected rows are copied at once
+        // only without them
+        if (input->index != NULL && stats == NULL && delimiters->numberOfOthers == 0 && row->number > 0) {
+            copyUnaffectedRows(input, output, row, functions);
+        }
+
+        long long start = startMeasure(stats != NULL);
+        int loaded = loadBatch(batch, input, row);
+        endBatchMeasure(stats, INPUT_COUNTER, start, loaded);
+        end = loaded < BATCH_SIZE;
+
+        // Rows from the limit aren't processed (there is an error in the first of them), rows before it are written
+        int limit = loaded;
+        err = verifyBatch(batch, &limit, input, functions, delimiters, layout, stats);
+
+        int selected = selectBatchRows(batch, limit, &function->selectFunction, getRowsSelection(functions) != NULL,
+                                       stats);
+        if (stats != NULL && function->selectFunction.type != ALL_ROWS) {
+            stats->rowsSelected += selected;
+        }
+
+        // Error of the function is always in an earlier row than the error of verification
+        start = startMeasure(stats != NULL);
+        ErrorInfo functionErr = applyBatchFunction(batch, &limit, function, delimiters->main);
+        endBatchMeasure(stats, FUNCTION_COUNTER, start, selected);
+        if (functionErr.error == true) {
+            err = functionErr;
+        }
+
+        start = startMeasure(stats != NULL);
+        writeBatch(output, batch, limit, layout, delimiters->main);
+        endBatchMeasure(stats, OUTPUT_COUNTER, start, limit);
+    }
+
+    freeArena(&batch->arena);
+    free(batch);
+
+    // The rest of input couldn't be loaded
+    if (err.error == false && input->failed == true) {
+        err.error = true;
+        err.message = "Nedostatek pameti pro nacitani vstupu.";
+    }
+
+    return err;
+}
+
+/**
+ * Loads next batch of rows (memory of rows of the previous batch is reused)
+ * @param batch Batch to load rows to
+ * @param input Input to load rows from
+ * @param row Row with number of the row before the batch (it gets number of the last loaded row)
+ * @return Number of loaded rows
+ */
+int loadBatch(Batch *batch, Input *input, Row *row) {
+    resetArena(&batch->arena);
+
+    int loaded = 0;
+    while (loaded < BATCH_SIZE) {
+        Row *batchRow = &batch->rows[loaded];
+        batchRow->number = row->number;
+        batchRow->last = row->last;
+        batchRow->arena = &batch->arena;
+        if (loadRow(batchRow, input) == false) {
+            break;
+        }
+
+        row->number = batchRow->number;
+        row->last = batchRow->last;
+        loaded++;
+    }
+
+    return loaded;
+}
+
+/**
+ * Verifies rows of the batch and indexes their cells (rows rejected by rows selection are only counted)
+ * @param batch Loaded batch (bitmaps of rows are set by this function)
+ * @param limit Number of rows to verify (it's lowered to the index of the first invalid row)
+ * @param input Input of the batch (cells of its rows can be already counted, see validateTable())
+ * @param functions Parsed and verified functions to apply
+ * @param delimiters Used delimiters
+ * @param layout Layout of output rows (it's prepared by the first row of the table)
+ * @param stats Statistics of processing (NULL if they aren't collected)
+ * @return Error information (of the first invalid row)
+ */
+ErrorInfo verifyBatch(Batch *batch, int *limit, const Input *input, const Function *functions,
+                      const Delimiters *delimiters, TableLayout *layout, Stats *stats) {
+    ErrorInfo err = {false};
+    memset(batch->indexed, 0, sizeof(batch->indexed));
+    memset(batch->selected, 0, sizeof(batch->selected));
+
+    // Rows selected by their numbers are accepted by function's selection, too (the first row is always indexed)
+    const SelectFunction *rowsSelection = getRowsSelection(functions);
+    long long start = startMeasure(stats != NULL);
+    int checked = 0;
+    for (int i = 0; i < *limit; i++) {
+        const Row *row = &batch->rows[i];
+        if (rowsSelection == NULL || row->number == 1) {
+            batch->indexed[i / 64] |= 1ULL << (i % 64);
+        } else {
+            checked++;
+            if (acceptsSelection(row, rowsSelection) == true) {
+                batch->indexed[i / 64] |= 1ULL << (i % 64);
+                batch->selected[i / 64] |= 1ULL << (i % 64);
+            }
+        }
+    }
+    endBatchMeasure(stats, SELECTION_COUNTER, start, checked);
+
+    // Validation (and delimiter processing)
+    start = startMeasure(stats != NULL);
+    int verified = 0;
+    for (; verified < *limit && err.error == false; verified++) {
+        Row *row = &batch->rows[verified];
+        if ((batch->indexed[verified / 64] >> (verified % 64) & 1) == 1) {
+            err = verifyRow(row, delimiters);
+            addRowStats(stats, row, err.error == false);
+        } else {
+            row->numberOfCells = input->numberOfColumns;
+            if (row->numberOfCells == 0 || delimiters->numberOfOthers > 0) {
+                countRowCells(row, delimiters);
+            }
+            addRowStats(stats, row, false);
+            if (row->outOfMemory == true) {
+                err.error = true;
+                err.message = "Nedostatek pameti pro zpracovani radku.";
+            }
+        }
+    }
+    endBatchMeasure(stats, DELIMITERS_COUNTER, start, verified);
+    if (err.error == true) {
+        *limit = verified - 1;
+    }
+
+    // Number of columns is set by the first row
+    start = startMeasure(stats != NULL);
+    for (int i = 0; i < *limit; i++) {
+        const Row *row = &batch->rows[i];
+        ErrorInfo rowErr = {false};
+        if (row->number == 1) {
+            rowErr = prepareTableLayout(layout, functions, row->numberOfCells, delimiters->main);
+        } else if (row->numberOfCells != layout->inputNumOfCols) {
+            rowErr.error = true;
+            rowErr.message = "Kazdy radek musi mit stejny pocet sloupcu.";
+        }
+
+        if (rowErr.error == true) {
+            err = rowErr;
+            *limit = i;
+        }
+    }
+    endBatchMeasure(stats, VERIFICATION_COUNTER, start, *limit);
+
+    return err;
+}
+
+/**
+ * Marks rows of the batch accepted by function's selection
+ * @param batch Verified batch
+ * @param limit Number of rows to check
+ * @param selection Function's selection
+ * @param resolved Has the selection been already resolved for rows after the first one? (see getRowsSelection())
+ * @param stats Statistics of processing (NULL if they aren't collected)
+ * @return Number of selected rows
+ */
+int selectBatchRows(Batch *batch, int limit, const SelectFunction *selection, bool resolved, Stats *stats) {
+    long long start = startMeasure(stats != NULL);
+    int checked = 0;
+    for (int i = nextBatchRow(batch->indexed, 0, limit); i < limit; i = nextBatchRow(batch->indexed, i + 1, limit)) {
+        const Row *row = &batch->rows[i];
+        if (resolved == true && row->number > 1) {
+            continue;
+        }
+
+        checked++;
+        if (acceptsSelection(row, selection) == true) {
+            batch->selected[i / 64] |= 1ULL << (i % 64);
+        }
+    }
+    endBatchMeasure(stats, SELECTION_COUNTER, start, checked);
+
+    int selected = 0;
+    for (int i = 0; i < (limit + 63) / 64; i++) {
+        unsigned long long used = limit - i * 64 >= 64 ? ~0ULL : (1ULL << (limit - i * 64)) - 1;
+        selected += __builtin_popcountll(batch->selected[i] & used);
+    }
+
+    return selected;
+}
+
+/**
+ * Applies data processing function to selected rows of the batch
+ * @param batch Batch with selected rows
+ * @param limit Number of rows to process (it's lowered to the index of the row with an error)
+ * @param function Function to apply
+ * @param delimiter Column delimiter
+ * @return Error information (of the first row with an error)
+ */
+ErrorInfo applyBatchFunction(Batch *batch, int *limit, const Function *function, char delimiter) {
+    ErrorInfo err = {false};
+
+    switch (function->type) {
+        case TOLOWER:
+        case TOUPPER:
+            return applyBatchCaseFunction(batch, limit, function);
+        case ROUND:
+        case INT:
+            return applyBatchNumberFunction(batch, limit, function);
+        default:
+            // Other functions change sizes or positions of cells, so they're applied row by row
+            break;
+    }
+
+    for (int i = nextBatchRow(batch->selected, 0, *limit); i < *limit;
+         i = nextBatchRow(batch->selected, i + 1, *limit)) {
+        Row *row = &batch->rows[i];
+        err = applyDataProcessingFunction(row, function, delimiter);
+        if (err.error == false && row->outOfMemory == true) {
+            err.error = true;
+            err.message = "Nedostatek pameti pro zpracovani radku.";
+        }
+
+        if (err.error == true) {
+            *limit = i;
+            break;
+        }
+    }
+
+    return err;
+}
+
+/**
+ * Changes case of letters in selected columns of selected rows of the batch (column by column)
+ * @param batch Batch with selected rows
+ * @param limit Number of rows to process (it's lowered to the index of the row with an error)
+ * @param function Function to apply (TOLOWER or TOUPPER)
+ * @return Error information (of the first row with an error)
+ */
+ErrorInfo applyBatchCaseFunction(Batch *batch, int *limit, const Function *function) {
+    ErrorInfo err = {false};
+
+    // Cells are converted in place, so rows are moved from read-only memory before their cells are gathered
+    for (int i = nextBatchRow(batch->selected, 0, *limit); i < *limit;
+         i = nextBatchRow(batch->selected, i + 1, *limit)) {
+        Row *row = &batch->rows[i];
+        if (function->params[0] <= row->numberOfCells && row->readOnly == true &&
+            moveRowToStorage(row, row->size) == false) {
+            err.error = true;
+            err.message = "Nedostatek pameti pro zpracovani radku.";
+            *limit = i;
+            break;
+        }
+    }
+
+    // All rows have the same number of columns, so there isn't any other column if the vector is empty
+    char start = function->type == TOLOWER ? 'A' : 'a';
+    for (int column = function->params[0]; column <= function->params[1]; column++) {
+        gatherColumn(batch, *limit, column);
+        if (batch->columnSize == 0) {
+            break;
+        }
+
+        for (int i = 0; i < batch->columnSize; i++) {
+            convertCase(batch->column[i].value, batch->column[i].size, start);
+        }
+    }
+
+    return err;
+}
+
+/**
+ * Rounds values or removes their decimal parts in selected column of selected rows of the batch (plain decimal numbers
+ * are converted for the whole column vector at once, then the results are set back to the rows)
+ * @param batch Batch with selected rows
+ * @param limit Number of rows to process (it's lowered to the index of the row with an error)
+ * @param function Function to apply (ROUND or INT)
+ * @return Error information (of the first row with an error)
+ */
+ErrorInfo applyBatchNumberFunction(Batch *batch, int *limit, const Function *function) {
+    ErrorInfo err = {false};
+
+    int column = function->params[0];
+    gatherColumn(batch, *limit, column);
+    for (int i = 0; i < batch->columnSize; i++) {
+        const CellSlice *slice = &batch->column[i];
+
+        DecimalNumber number;
+        if (scanDecimalNumber(slice->value, slice->size, &number) == false) {
+            batch->resultSizes[i] = -1;
+        } else if (function->type == ROUND) {
+            batch->resultSizes[i] = formatRoundedNumber(&number, batch->results[i]);
+        } else {
+            batch->resultSizes[i] = formatIntegerPart(&number, batch->results[i]);
+        }
+    }
+
+    // Other values are converted by the row's function (it reports invalid numbers)
+    for (int i = 0; i < batch->columnSize; i++) {
+        const CellSlice *slice = &batch->column[i];
+        Row *row = &batch->rows[slice->row];
+
+        if (batch->resultSizes[i] < 0) {
+            err = function->type == ROUND ? roundColumnValue(column, row) : removeColumnDecimalPart(column, row);
+        } else if (batch->resultSizes[i] != slice->size || memcmp(batch->results[i], slice->value, slice->size) != 0) {
+            setColumnValue(batch->results[i], row, column);
+        }
+
+        if (err.error == false && row->outOfMemory == true) {
+            err.error = true;
+            err.message = "Nedostatek pameti pro zpracovani radku.";
+        }
+
+        if (err.error == true) {
+            *limit = slice->row;
+            break;
+        }
+    }
+
+    return err;
+}
+
+/**
+ * Gathers cells of the column of selected rows of the batch into column vector
+ * @param batch Batch with selected rows
+ * @param limit Number of rows to gather cells from
+ * @param column Gathered column (rows without the column are skipped)
+ */
+void gatherColumn(Batch *batch, int limit, int column) {
+    batch->columnSize = 0;
+    for (int i = nextBatchRow(batch->selected, 0, limit); i < limit; i = nextBatchRow(batch->selected, i + 1, limit)) {
+        Row *row = &batch->rows[i];
+        if (column > row->numberOfCells) {
+            continue;
+        }
+
+        CellSlice *slice = &batch->column[batch->columnSize++];
+        slice->value = &row->data[getCellStart(row, column)];
+        slice->size = getCellSize(row, column);
+        slice->row = i;
+    }
+}
+
+/**
+ * Writes processed rows of the batch to output
+ * @param output Output to write to
+ * @param batch Processed batch
+ * @param limit Number of rows to write
+ * @param layout Layout of output rows
+ * @param delimiter Column delimiter
+ */
+void writeBatch(Output *output, const Batch *batch, int limit, const TableLayout *layout, char delimiter) {
+    for (int i = 0; i < limit; i++) {
+        const Row *row = &batch->rows[i];
+        if (layout->rearranged == true && (batch->indexed[i / 64] >> (i % 64) & 1) == 1) {
+            writeRearrangedRow(output, row, layout, delimiter);
+        } else {
+            writeProcessedRow(output, row);
+        }
+    }
+}
+
+/**
+ * Finds the next row marked in bitmap of the batch's rows
+ * @param bitmap Bitmap of rows (see Batch)
+ * @param row Index of the first row to check
+ * @param limit Index after the last row to check
+ * @return Index of the found row or the limit if there isn't any
+ */
+int nextBatchRow(const unsigned long long *bitmap, int row, int limit) {
+    while (row < limit) {
+        unsigned long long bits = bitmap[row / 64] >> (row % 64);
+        if (bits != 0) {
+            row += __builtin_ctzll(bits);
+
+            return row < limit ? row : limit;
+        }
+
+        row = (row / 64 + 1) * 64;
+    }
+
+    return limit;
+}
+
+/***********************************************************************************************************Statistics*/
+/**
+ * Checks if times should be measured for the next row
+ * @param stats Statistics of processing (NULL if they aren't collected)
+ * @return Should times be measured?
+ */
+bool isSampled(const Stats *stats) {
+    // The first row isn't measured, its processing is slower (the first memory allocations, reading of input)
+    return stats != NULL && stats->counters[INPUT_COUNTER].calls % STATS_SAMPLE_INTERVAL == STATS_SAMPLE_INTERVAL - 1;
+}
+
+/**
+ * Starts measuring of a stage
+ * @param sampled Is time measured for the actual row?
+ * @return Start time of the stage (or 0 if time isn't measured)
+ */
+long long startMeasure(bool sampled) {
+    return sampled == true ? getTime() : 0;
+}
+
+/**
+ * Ends measuring of a stage (the stage is counted even if its time isn't measured)
+ * @param stats Statistics of processing (NULL if they aren't collected)
+ * @param counter Counter of the stage (see StatsCounterType)
+ * @param start Start time of the stage (from startMeasure())
+ * @param sampled Is time measured for the actual row?
+ */
+void endMeasure(Stats *stats, int counter, long long start, bool sampled) {
+    if (stats == NULL) {
+        return;
+    }
+
+    StatsCounter *statsCounter = &stats->counters[counter];
+    statsCounter->calls++;
+    if (sampled == true) {
+        statsCounter->sampledCalls++;
+        statsCounter->measurements++;
+        statsCounter->time += getTime() - start;
+    }
+}
+
+/**
+ * Ends measuring of a stage applied to a batch of rows (the time is always measured, it's shared by all rows)
+ * @param stats Statistics of processing (NULL if they aren't collected)
+ * @param counter Counter of the stage (see StatsCounterType)
+ * @param start Start time of the stage (from startMeasure())
+ * @param calls Number of rows the stage has been applied to
+ */
+void endBatchMeasure(Stats *stats, int counter, long long start, int calls) {
+    if (stats == NULL || calls == 0) {
+        return;
+    }
+
+    StatsCounter *statsCounter = &stats->counters[counter];
+    statsCounter->calls += calls;
+    statsCounter->sampledCalls += calls;
+    statsCounter->measurements++;
+    statsCounter->time += getTime() - start;
+}
+
+/**
+ * Adds sizes of the loaded row to statistics
+ * @param stats Statistics of processing (NULL if they aren't collected)
+ * @param row Loaded row
+ * @param indexed Are row's cells indexed? (sizes of cells are known only for indexed rows)
+ */
+void addRowStats(Stats *stats, const Row *row, bool indexed) {
+    if (stats == NULL) {
+        return;
+    }
+
+    stats->bytesIn += row->size;
+    if (row->size > stats->maxRowSize) {
+        stats->maxRowSize = row->size;
+    }
+
+    for (int i = 1; indexed == true && i <= row->numberOfCells; i++) {
+        if (getCellSize(row, i) > stats->maxCellSize) {
+            stats->maxCellSize = getCellSize(row, i);
+        }
+    }
+}
+
+/**
+ * Adds statistics to other ones
+ * @param target Statistics to add to
+ * @param source Added statistics
+ */
+void mergeStats(Stats *target, const Stats *source) {
+    for (int i = 0; i < NUMBER_OF_COUNTERS; i++) {
+        target->counters[i].calls += source->counters[i].calls;
+        target->counters[i].sampledCalls += source->counters[i].sampledCalls;
+        target->counters[i].measurements += source->counters[i].measurements;
+        target->counters[i].time += source->counters[i].time;
+    }
+
+    target->bytesIn += source->bytesIn;
+    target->rowsSelected += source->rowsSelected;
+    target->rowsDeleted += source->rowsDeleted;
+    target->rowsInserted += source->rowsInserted;
+    if (source->maxRowSize > target->maxRowSize) {
+        target->maxRowSize = source->maxRowSize;
+    }
+    if (source->maxCellSize > target->maxCellSize) {
+        target->maxCellSize = source->maxCellSize;
+    }
+}
+
+/**
+ * Writes statistics to standard error output (times of stages are estimated from measured calls without time of
+ * measuring itself)
+ * @param stats Statistics of processing
+ * @param functions Parsed functions (for names of their counters)
+ * @param bytesOut Number of bytes written to output
+ */
+void writeStats(const Stats *stats, const Function *functions, long long bytesOut) {
+    const char *names[FUNCTION_COUNTER] = {
+            [INPUT_COUNTER] = "nacitani radku",
+            [DELIMITERS_COUNTER] = "oddelovace",
+            [VERIFICATION_COUNTER] = "kontrola radku",
+            [SELECTION_COUNTER] = "vyber radku",
+            [OUTPUT_COUNTER] = "zapis radku",
+    };
+
+    // Measuring of a stage takes some time, too
+    long long start = getTime();
+    for (int i = 0; i < STATS_SAMPLE_INTERVAL; i++) {
+        getTime();
+    }
+    long long overhead = (getTime() - start) / (STATS_SAMPLE_INTERVAL + 1);
+
+    fprintf(stderr, "sheet: statistiky (cas je odhadnut z kazdeho %d. radku)\n", STATS_SAMPLE_INTERVAL);
+    fprintf(stderr, "%-24s %14s %14s\n", "faze", "volani", "cas [ms]");
+    for (int i = 0; i < NUMBER_OF_COUNTERS; i++) {
+        const StatsCounter *counter = &stats->counters[i];
+        if (i >= FUNCTION_COUNTER && functions[i - FUNCTION_COUNTER].type == NO_FUNCTION) {
+            break;
+        }
+
+        double time = 0;
+        long long measured = counter->time - counter->measurements * overhead;
+        if (counter->sampledCalls > 0 && measured > 0) {
+            time = (double)measured * (double)counter->calls / (double)counter->sampledCalls / 1e6;
+        }
+
+        if (i < FUNCTION_COUNTER) {
+            fprintf(stderr, "%-24s %14lld %14.3f\n", names[i], counter->calls, time);
+        } else {
+            char name[32];
+            snprintf(name, sizeof(name), "%d. %s", i - FUNCTION_COUNTER + 1,
+                     functionDefinitions[functions[i - FUNCTION_COUNTER].type].name);
+            fprintf(stderr, "%-24s %14lld %14.3f\n", name, counter->calls, time);
+        }
+    }
+
+    fprintf(stderr, "bajty: vstup %lld, vystup %lld\n", stats->bytesIn, bytesOut);
+    fprintf(stderr, "radky: vybrane %lld, smazane %lld, vlozene %lld\n", stats->rowsSelected, stats->rowsDeleted,
+            stats->rowsInserted);
+    fprintf(stderr, "nejvetsi velikost: radek %d, bunka %d\n", stats->maxRowSize, stats->maxCellSize);
+}
+
+/**
+ * Returns actual time of monotonic clock
+ * @return Time in nanoseconds
+ */
+long long getTime(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (long long)time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+/**********************************************************************************************Table editing functions*/
+/**
+ * Marks rows from selected interval as deleted
+ * @param from First selected row
+ * @param to Last selected row (interval is checked by verifyFunctions())
+ * @param row Actual row
+ */
+void drows(int from, int to, Row *row) {
+    if (row->number >= from && row->number <= to) {
+        row->deleted = true;
+    }
+}
+
+/**
+ * Deletes row's columns from selected range
+ * @param from First selected column number
+ * @param to Last selected column number (interval is checked by verifyFunctions())
+ * @param row Operated row
+ */
+void dcols(int from, int to, Row *row) {
+    // Only existing columns can be deleted
+    if (from > row->numberOfCells) {
+        return;
+    }
+    if (to > row->numberOfCells) {
+        to = row->numberOfCells;
+    }
+
+    int start = getCellStart(row, from);
+    int end = row->cells[to]; // Start of the next column (after delimiter)
+    int remaining = row->numberOfCells - to; // Number of columns after deleted ones
+    if (remaining == 0) {
+        // The last column is being removed, so delimiter before deleted columns must be deleted (if there is some)
+        end--;
+        if (from > 1) {
+            start--;
+        }
+    }
+    replaceRowData(row, start, end, NULL, 0);
+    if (row->outOfMemory == true) {
+        return;
+    }
+
+    // Ensure \n at the end of the row (it isn't a part of any cell, so the index isn't affected)
+    if (row->size == 0 || row->data[row->size - 1] != '\n') {
+        replaceRowData(row, row->size, row->size, "\n", 1);
+    }
+
+    if (from == 1 && remaining == 0) {
+        // Row without any columns still has one empty cell
+        row->numberOfCells = 1;
+        row->cells[1] = 1;
+
+        return;
+    }
+
+    // Cells after the deleted ones move to their place (the end of the last cell is moved with them)
+    for (int i = 0; i <= remaining; i++) {
+        row->cells[from - 1 + i] = row->cells[to + i] - (end - start);
+    }
+    row->numberOfCells -= to - from + 1;
+}
+
+/********************************************************************************************Data processing functions*/
+/**
+ * Sets selected column's value
+ * @param column Selected column's number
+ * @param value Value to set to the column
+ * @param row Row contains the column
+ * @return Error information
+ */
+ErrorInfo cset(int column, const char *value, Row *row) {
+    ErrorInfo errorInfo = {false};
+
+    setColumnValue(value, row, column);
+
+    return errorInfo;
+}
+
+/**
+ * Changes case of letters in selected columns
+ * @param newCase New case of letters (LOWER_CASE or UPPER_CASE)
+ * @param from First selected column
+ * @param to Last selected column (interval is checked by verifyFunctions())
+ * @param row Row contains the columns
+ */
+void changeColumnCase(bool newCase, int from, int to, Row *row) {
+    // Columns that don't exist can't be changed
+    if (from > row->numberOfCells) {
+        return;
+    }
+    if (to > row->numberOfCells) {
+        to = row->numberOfCells;
+    }
+
+    // Size of the cells isn't changed, so they're converted in place
+    if (row->readOnly == true && moveRowToStorage(row, row->size) == false) {
+        return;
+    }
+
+    // Cells are converted one by one, delimiters between them must stay as they are
+    char start = newCase == LOWER_CASE ? 'A' : 'a';
+    for (int column = from; column <= to; column++) {
+        convertCase(&row->data[getCellStart(row, column)], getCellSize(row, column), start);
+    }
+}
+
+/**
+ * Rounds value in selected column
+ * @param column Selected column
+ * @param row Row contains the column
+ * @return Error information
+ */
+ErrorInfo roundColumnValue(int column, Row *row) {
+    ErrorInfo errorInfo = {false};
+
+    // Column that doesn't exist can't be changed
+    if (column > row->numberOfCells) {
+        return errorInfo;
+    }
+
+    // Result can be longer than the value (e.g. 1e300); it's in row's memory as it can override the cell
+    char *result = allocateRowMemory(row, DBL_MAX_10_EXP + 3);
+    if (result == NULL) {
+        return errorInfo;
+    }
+    int resultSize;
+    const char *cell = &row->data[getCellStart(row, column)];
+    int cellSize = getCellSize(row, column);
+
+    // Plain decimal numbers are rounded directly in their digits, other values are converted by strtod()
+    DecimalNumber number;
+    if (scanDecimalNumber(cell, cellSize, &number) == true) {
+        resultSize = formatRoundedNumber(&number, result);
+    } else {
+        char *value = getColumnValue(row, column);
+        if (value == NULL) {
+            return errorInfo;
+        }
+
+        // The cells must contains valid number
+        if (isValidNumber(value) == false) {
+            errorInfo.error = true;
+            errorInfo.message = "Funkci round nelze provest na bunce, ktera neobsahuje validni cislo.";
+
+            return errorInfo;
+        }
+
+        resultSize = sprintf(result, "%.f", strtod(value, NULL));
+    }
+
+    // Already rounded values (plain integers) stay as they are
+    if (resultSize != cellSize || memcmp(result, cell, resultSize) != 0) {
+        setColumnValue(result, row, column);
+    }
+
+    return errorInfo;
+}
+
+/**
+ * Removes decimal part from selected column's value (only removes, without rounding)
+ * @param column Selected column
+ * @param row Row contains the column
+ * @return Error information
+ */
+ErrorInfo removeColumnDecimalPart(int column, Row *row) {
+    ErrorInfo errorInfo = {false};
+
+    // Column that doesn't exist can't be changed
+    if (column > row->numberOfCells) {
+        return errorInfo;
+    }
+
+    // Result is in row's memory as it can override the cell
+    char *result = allocateRowMemory(row, DBL_MAX_10_EXP + 3);
+    if (result == NULL) {
+        return errorInfo;
+    }
+    int resultSize;
+    const char *cell = &row->data[getCellStart(row, column)];
+    int cellSize = getCellSize(row, column);
+
+    // Plain decimal numbers are cut directly in their digits, other values are converted by strtod()
+    DecimalNumber number;
+    if (scanDecimalNumber(cell, cellSize, &number) == true) {
+        resultSize = formatIntegerPart(&number, result);
+    } else {
+        char *value = getColumnValue(row, column);
+        if (value == NULL) {
+            return errorInfo;
+        }
+
+        // The cells must contains valid number
+        if (isValidNumber(value) == false) {
+            errorInfo.error = true;
+            errorInfo.message = "Funkci int nelze provest na bunce, ktera neobsahuje validni cislo.";
+
+            return errorInfo;
+        }
+
+        // Numbers out of range of long long don't have any decimal part
+        double integer = strtod(value, NULL);
+        if (integer > -LLONG_MAX && integer < LLONG_MAX) {
+            integer = (double)(long long)integer;
+        }
+        resultSize = sprintf(result, "%.f", integer);
+    }
+
+    // Values without decimal part (plain integers) stay as they are
+    if (resultSize != cellSize || memcmp(result, cell, resultSize) != 0) {
+        setColumnValue(result, row, column);
+    }
+
+    return errorInfo;
+}
+
+/**
+ * Copies column's value to another column
+ * @param from Source column
+ * @param to Target column
+ * @param row Row contains columns
+ */
+void copy(int from, int to, Row *row) {
+    // One of the selected columns doesn't exists, so this function can't change anything
+    if ((from > row->numberOfCells) || (to > row->numberOfCells)) {
+        return;
+    }
+
+    char *value = getColumnValue(row, from);
+    if (value == NULL) {
+        return;
+    }
+
+    setColumnValue(value, row, to);
+}
+
+/**
+ * Swaps values of selected columns
+ * @param first First selected column
+ * @param second Second selected column
  * @param row Row contains columns
- * @param delimiter Column delimiter
- * @param numberOfColumns Number of columns in the row
  */
-void swap(int first, int second, Row *row, char delimiter, int numberOfColumns) {
+void swap(int first, int second, Row *row) {
     // One of the selected columns doesn't exists, so this function can't change anything
-    if ((first > numberOfColumns) || (second > numberOfColumns)) {
+    if ((first > row->numberOfCells) || (second > row->numberOfCells)) {
         return;
     }
 
-    char firstValue[MAX_CELL_SIZE];
-    char secondValue[MAX_CELL_SIZE];
-    getColumnValue(firstValue, row, first, delimiter, numberOfColumns);
-    getColumnValue(secondValue, row, second, delimiter, numberOfColumns);
+    char *firstValue = getColumnValue(row, first);
+    char *secondValue = getColumnValue(row, second);
+    if (firstValue == NULL || secondValue == NULL) {
+        return;
+    }
 
     // Column numbers should be OK, so errors aren't expected
-    setColumnValue(firstValue, row, second, delimiter, numberOfColumns);
-    setColumnValue(secondValue, row, first, delimiter, numberOfColumns);
+    setColumnValue(firstValue, row, second);
+    setColumnValue(secondValue, row, first);
 }
 
 /**
@@ -908,11 +4884,10 @@ void swap(int first, int second, Row *row, char delimiter, int numberOfColumns)
  * @param beforeColumn Selected column to move the first before
  * @param row Row contains the column
  * @param delimiter Column delimiter
- * @param numberOfColumns Number of column in the row
  */
-void move(int column, int beforeColumn, Row *row, char delimiter, int numberOfColumns) {
+void move(int column, int beforeColumn, Row *row, char delimiter) {
     // One of the selected columns doesn't exists, so this function can't change anything
-    if ((column > numberOfColumns) || (beforeColumn > numberOfColumns)) {
+    if ((column > row->numberOfCells) || (beforeColumn > row->numberOfCells)) {
         return;
     }
 
@@ -921,93 +4896,393 @@ void move(int column, int beforeColumn, Row *row, char delimiter, int numberOfCo
         return;
     }
 
-    char moving[2 * MAX_CELL_SIZE];
-    char second[MAX_CELL_SIZE];
-    getColumnValue(moving, row, column, delimiter, numberOfColumns);
-    getColumnValue(second, row, beforeColumn, delimiter, numberOfColumns);
+    // The moving column will be added before the second selected column (they're set as one value)
+    int movingSize = getCellSize(row, column);
+    int secondSize = getCellSize(row, beforeColumn);
+    char *value = allocateRowMemory(row, movingSize + secondSize + 2);
+    if (value == NULL) {
+        return;
+    }
+
+    memcpy(value, &row->data[getCellStart(row, column)], movingSize);
+    value[movingSize] = delimiter;
+    memcpy(&value[movingSize + 1], &row->data[getCellStart(row, beforeColumn)], secondSize);
+    value[movingSize + secondSize + 1] = '\0';
 
     // Delete column for move
     // Should be OK -> from this column has been successfully extracted before
-    dcols(column, column, row, delimiter);
+    dcols(column, column, row);
 
     // In this case column numbers will be moved by 1 to left and it's important to count with it
     if (beforeColumn > column) {
         beforeColumn--;
     }
 
-    // Add the moving column before second selected column
-    moving[strlen(moving)] = delimiter;
-    strcat(moving, second);
-    setColumnValue(moving, row, beforeColumn, delimiter, numberOfColumns);
+    setColumnValue(value, row, beforeColumn);
 }
 
 /*******************************************************************************************************Help functions*/
 /**
- * Checks if the provided char is a delimiter
- * @param c Char for checking
+ * Indexes cells of the row (finds start positions of all cells), so they can be accessed directly
+ * Delimiters are unified on the way - all of them are replaced with the main one.
+ * @param row Row to index (its trailing \n isn't a part of the last cell)
+ * @param delimiters Used delimiters
+ */
+void indexRowCells(Row *row, const Delimiters *delimiters) {
+    // \n used as other delimiter is replaced even at the end of the row
+    int end = row->size;
+    if (end > 0 && row->data[end - 1] == '\n' && delimiters->classes['\n'] != DELIMITER_CHAR) {
+        end--;
+    }
+
+    // Every char can be a delimiter
+    if (reserveRowCells(row, end + 1) == false) {
+        return;
+    }
+
+    // Even empty row has one (empty) cell
+    row->cells[0] = 0;
+    row->numberOfCells = 1;
+    delimiters->indexCells(row, delimiters, 0, end);
+
+    // The end of the last cell is stored as start of the next (non-existing) cell
+    row->cells[row->numberOfCells] = end + 1;
+}
+
+/**
+ * Counts cells of the row without indexing them (delimiters are unified the same way as by indexRowCells())
+ * @param row Row to count cells of
  * @param delimiters Used delimiters
- * @return Is the char a delimiter?
+ * @return Number of row's cells
  */
-bool isDelimiter(char c, const char **delimiters) {
-    char delimiter;
+int countRowCells(Row *row, const Delimiters *delimiters) {
+    // Other delimiters must be replaced, so the row is processed by the indexing kernel
+    if (delimiters->numberOfOthers > 0) {
+        indexRowCells(row, delimiters);
+
+        return row->numberOfCells;
+    }
+
+    int end = row->size;
+    if (end > 0 && row->data[end - 1] == '\n') {
+        end--;
+    }
+
+    // Main delimiters are counted by 8 chars at once - matching chars become zero bytes and these are counted
+    const unsigned long long lowBits = 0x7F7F7F7F7F7F7F7FULL;
+    const unsigned long long pattern = 0x0101010101010101ULL * (unsigned char) delimiters->main;
+    int count = 1;
     int i = 0;
-    while ((delimiter = (*delimiters)[i]) != '\0') {
-        if (c == delimiter) {
-            return true;
+    for (; i + 8 <= end; i += 8) {
+        unsigned long long block;
+        memcpy(&block, &row->data[i], sizeof(block));
+        block ^= pattern;
+        count += __builtin_popcountll(~(((block & lowBits) + lowBits) | block | lowBits));
+    }
+    for (; i < end; i++) {
+        count += row->data[i] == delimiters->main;
+    }
+
+    row->numberOfCells = count;
+
+    return count;
+}
+
+/**
+ * Indexes cells in the part of row's data char by char (reference kernel for indexRowCells())
+ * @param row Row to index (cells before the start have already been indexed)
+ * @param delimiters Used delimiters
+ * @param start Position of the first char to process
+ * @param end Position after the last char to process
+ */
+void indexCellsScalar(Row *row, const Delimiters *delimiters, int start, int end) {
+    for (int i = start; i < end; i++) {
+        unsigned char class = delimiters->classes[(unsigned char) row->data[i]];
+
+        if (class == DELIMITER_CHAR) {
+            if (row->readOnly == true && moveRowToStorage(row, row->size) == false) {
+                return;
+            }
+
+            row->data[i] = delimiters->main;
+        } else if (class != MAIN_DELIMITER_CHAR) {
+            continue;
         }
 
-        i++;
+        row->cells[row->numberOfCells++] = i + 1;
     }
+}
 
-    return false;
+/**
+ * Indexes cells in the part of row's data with the main delimiter only (reference kernel for a single delimiter)
+ * @param row Row to index (cells before the start have already been indexed)
+ * @param delimiters Used delimiters (there are no other delimiters)
+ * @param start Position of the first char to process
+ * @param end Position after the last char to process
+ */
+void indexCellsSingle(Row *row, const Delimiters *delimiters, int start, int end) {
+    const char *data = row->data;
+    for (int i = start; i < end; i++) {
+        const char *delimiter = memchr(&data[i], delimiters->main, end - i);
+        if (delimiter == NULL) {
+            return;
+        }
+
+        i = (int)(delimiter - data);
+        row->cells[row->numberOfCells++] = i + 1;
+    }
 }
 
+#ifdef X86_SIMD
 /**
- * Checks cells' size
- * @param row Row to check cells in
- * @param delimiter Cell delimiter
- * @return Does the row contain only valid-sized cells?
+ * Indexes cells in the part of row's data by blocks of 16 chars (SSE2 kernel for indexRowCells())
+ * @param row Row to index (cells before the start have already been indexed)
+ * @param delimiters Used delimiters (there are at most MAX_SIMD_DELIMITERS other delimiters)
+ * @param start Position of the first char to process
+ * @param end Position after the last char to process
  */
-bool checkCellsSize(const Row *row, char delimiter) {
-    int size = 0;
-    for (int i = 0; i < row->size; i++) {
-        if (row->data[i] != delimiter) {
-            size++;
-        } else {
-            size = 0;
+__attribute__((target("sse2")))
+void indexCellsSse2(Row *row, const Delimiters *delimiters, int start, int end) {
+    const __m128i mainDelimiter = _mm_set1_epi8(delimiters->main);
+    __m128i otherDelimiters[MAX_SIMD_DELIMITERS];
+    for (int i = 0; i < delimiters->numberOfOthers; i++) {
+        otherDelimiters[i] = _mm_set1_epi8(delimiters->others[i]);
+    }
+
+    int i = start;
+    for (; i + 16 <= end; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *) &row->data[i]);
+        __m128i others = _mm_setzero_si128();
+        for (int j = 0; j < delimiters->numberOfOthers; j++) {
+            others = _mm_or_si128(others, _mm_cmpeq_epi8(block, otherDelimiters[j]));
         }
 
-        if (size > MAX_CELL_SIZE) {
-            return false;
+        unsigned int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, mainDelimiter), others));
+        if (mask == 0) {
+            continue;
+        }
+
+        if (_mm_movemask_epi8(others) != 0) {
+            if (row->readOnly == true && moveRowToStorage(row, row->size) == false) {
+                return;
+            }
+
+            block = _mm_or_si128(_mm_andnot_si128(others, block), _mm_and_si128(others, mainDelimiter));
+            _mm_storeu_si128((__m128i *) &row->data[i], block);
         }
+
+        addCellStarts(row, mask, i);
     }
 
-    return true;
+    // Rest of data (shorter than one block)
+    indexCellsScalar(row, delimiters, i, end);
+}
+
+/**
+ * Indexes cells in the part of row's data by blocks of 32 chars (AVX2 kernel for indexRowCells())
+ * @param row Row to index (cells before the start have already been indexed)
+ * @param delimiters Used delimiters (there are at most MAX_SIMD_DELIMITERS other delimiters)
+ * @param start Position of the first char to process
+ * @param end Position after the last char to process
+ */
+__attribute__((target("avx2")))
+void indexCellsAvx2(Row *row, const Delimiters *delimiters, int start, int end) {
+    const __m256i mainDelimiter = _mm256_set1_epi8(delimiters->main);
+    __m256i otherDelimiters[MAX_SIMD_DELIMITERS];
+    for (int i = 0; i < delimiters->numberOfOthers; i++) {
+        otherDelimiters[i] = _mm256_set1_epi8(delimiters->others[i]);
+    }
+
+    int i = start;
+    for (; i + 32 <= end; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *) &row->data[i]);
+        __m256i others = _mm256_setzero_si256();
+        for (int j = 0; j < delimiters->numberOfOthers; j++) {
+            others = _mm256_or_si256(others, _mm256_cmpeq_epi8(block, otherDelimiters[j]));
+        }
+
+        unsigned int mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, mainDelimiter), others));
+        if (mask == 0) {
+            continue;
+        }
+
+        if (_mm256_testz_si256(others, others) == 0) {
+            if (row->readOnly == true && moveRowToStorage(row, row->size) == false) {
+                return;
+            }
+
+            _mm256_storeu_si256((__m256i *) &row->data[i], _mm256_blendv_epi8(block, mainDelimiter, others));
+        }
+
+        addCellStarts(row, mask, i);
+    }
+
+    // Rest of data (shorter than one block)
+    indexCellsSse2(row, delimiters, i, end);
+}
+
+/**
+ * Indexes cells in the part of row's data with the main delimiter only by blocks of 16 chars (SSE2 kernel for a single
+ * delimiter)
+ * @param row Row to index (cells before the start have already been indexed)
+ * @param delimiters Used delimiters (there are no other delimiters)
+ * @param start Position of the first char to process
+ * @param end Position after the last char to process
+ */
+__attribute__((target("sse2")))
+void indexCellsSingleSse2(Row *row, const Delimiters *delimiters, int start, int end) {
+    const __m128i mainDelimiter = _mm_set1_epi8(delimiters->main);
+
+    int i = start;
+    for (; i + 16 <= end; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *) &row->data[i]);
+        addCellStarts(row, _mm_movemask_epi8(_mm_cmpeq_epi8(block, mainDelimiter)), i);
+    }
+
+    // Rest of data (shorter than one block)
+    indexCellsSingle(row, delimiters, i, end);
+}
+
+/**
+ * Indexes cells in the part of row's data with the main delimiter only by blocks of 32 chars (AVX2 kernel for a single
+ * delimiter)
+ * @param row Row to index (cells before the start have already been indexed)
+ * @param delimiters Used delimiters (there are no other delimiters)
+ * @param start Position of the first char to process
+ * @param end Position after the last char to process
+ */
+__attribute__((target("avx2")))
+void indexCellsSingleAvx2(Row *row, const Delimiters *delimiters, int start, int end) {
+    const __m256i mainDelimiter = _mm256_set1_epi8(delimiters->main);
+
+    int i = start;
+    for (; i + 32 <= end; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *) &row->data[i]);
+        addCellStarts(row, _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, mainDelimiter)), i);
+    }
+
+    // Rest of data (shorter than one block)
+    indexCellsSingleSse2(row, delimiters, i, end);
+}
+#endif
+
+#ifdef NEON_SIMD
+/**
+ * Indexes cells in the part of row's data by blocks of 16 chars (NEON kernel for indexRowCells())
+ * @param row Row to index (cells before the start have already been indexed)
+ * @param delimiters Used delimiters (there are at most MAX_SIMD_DELIMITERS other delimiters)
+ * @param start Position of the first char to process
+ * @param end Position after the last char to process
+ */
+void indexCellsNeon(Row *row, const Delimiters *delimiters, int start, int end) {
+    const uint8x16_t mainDelimiter = vdupq_n_u8((uint8_t) delimiters->main);
+    uint8x16_t otherDelimiters[MAX_SIMD_DELIMITERS];
+    for (int i = 0; i < delimiters->numberOfOthers; i++) {
+        otherDelimiters[i] = vdupq_n_u8((uint8_t) delimiters->others[i]);
+    }
+
+    int i = start;
+    for (; i + 16 <= end; i += 16) {
+        uint8x16_t block = vld1q_u8((const uint8_t *) &row->data[i]);
+        uint8x16_t others = vdupq_n_u8(0);
+        for (int j = 0; j < delimiters->numberOfOthers; j++) {
+            others = vorrq_u8(others, vceqq_u8(block, otherDelimiters[j]));
+        }
+
+        // NEON has no movemask, every char is represented by 4 bits of the mask instead
+        uint8x16_t matches = vorrq_u8(vceqq_u8(block, mainDelimiter), others);
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+        if (mask == 0) {
+            continue;
+        }
+
+        if (vmaxvq_u8(others) != 0) {
+            if (row->readOnly == true && moveRowToStorage(row, row->size) == false) {
+                return;
+            }
+
+            vst1q_u8((uint8_t *) &row->data[i], vbslq_u8(others, mainDelimiter, block));
+        }
+
+        mask &= 0x8888888888888888ULL;
+        while (mask != 0) {
+            row->cells[row->numberOfCells++] = i + (__builtin_ctzll(mask) >> 2) + 1;
+            mask &= mask - 1;
+        }
+    }
+
+    // Rest of data (shorter than one block)
+    indexCellsScalar(row, delimiters, i, end);
+}
+#endif
+
+/**
+ * Adds cell starts for delimiters found by SIMD kernel
+ * @param row Indexed row
+ * @param delimiterMask Bit mask of delimiter positions (the lowest bit is the first char of the block)
+ * @param offset Position of the block in row's data
+ */
+void addCellStarts(Row *row, unsigned int delimiterMask, int offset) {
+    while (delimiterMask != 0) {
+        row->cells[row->numberOfCells++] = offset + __builtin_ctz(delimiterMask) + 1;
+        delimiterMask &= delimiterMask - 1;
+    }
+}
+
+/**
+ * Returns start position of the cell in row's data
+ * @param row Indexed row
+ * @param column Column number of the cell (from 1, must exist)
+ * @return Index of the first char of the cell
+ */
+int getCellStart(const Row *row, int column) {
+    return row->cells[column - 1];
 }
 
 /**
- * Counts number of columns in provided row
- * @param row Row
- * @param delimiter Column delimiter
- * @return Number of columns in the row
+ * Returns size of the cell
+ * @param row Indexed row
+ * @param column Column number of the cell (from 1, must exist)
+ * @return Number of chars in the cell (without delimiter)
  */
-int countColumns(Row *row, char delimiter) {
-    // Empty row has always 0 columns
-    if (row->size == 0) {
-        return 0;
-    }
+int getCellSize(const Row *row, int column) {
+    return row->cells[column] - row->cells[column - 1] - 1;
+}
 
-    // Non-empty row has 1 column minimally
-    int counter = 1;
+/**
+ * Converts case of ASCII letters by 8 chars at once (letters are found by range checks of all chars of a block)
+ * @param value Value to convert in place
+ * @param size Size of the value
+ * @param start The first letter of converted letters ('A' for conversion to lower case, 'a' for upper case)
+ */
+void convertCase(char *value, int size, char start) {
+    const unsigned long long lowBits = 0x7F7F7F7F7F7F7F7FULL;
+    const unsigned long long highBits = 0x8080808080808080ULL;
+    const unsigned long long aboveStart = 0x0101010101010101ULL * (unsigned char) (0x80 - start);
+    const unsigned long long aboveEnd = 0x0101010101010101ULL * (unsigned char) (0x80 - (start + ('z' - 'a') + 1));
 
-    // Every next delimiter =>  next column
-    for (int i = 0; i < row->size; i++) {
-        if (row->data[i] == delimiter) {
-            counter++;
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        unsigned long long block;
+        memcpy(&block, &value[i], sizeof(block));
+
+        // High bit of each char is set if the char is in the range (no carry can cross chars, they're only 7-bit)
+        unsigned long long chars = block & lowBits;
+        unsigned long long letters = (chars + aboveStart) & ~(chars + aboveEnd) & ~block & highBits;
+        if (letters == 0) {
+            continue;
         }
+
+        // Upper and lower case letters differ only in one bit
+        block ^= letters >> 2;
+        memcpy(&value[i], &block, sizeof(block));
     }
 
-    return counter;
+    for (; i < size; i++) {
+        if ((value[i] >= start) && (value[i] <= start + ('z' - 'a'))) {
+            value[i] = (char)(value[i] ^ ('a' - 'A'));
+        }
+    }
 }
 
 /**
@@ -1019,113 +5294,150 @@ int countColumns(Row *row, char delimiter) {
  */
 ErrorInfo getFunctionFromArgs(Function *function, const InputArguments *args, int *position) {
     ErrorInfo errorInfo = {false};
-    char *functions[16] = {
-            "arow", "irow", "drow", "drows", "icol", "acol", "dcol", "dcols", "cset", "tolower", "toupper", "round",
-            "int", "copy", "swap", "move"
-    };
-    int funcArgs[16] = {0, 1, 1, 2, 1, 0, 1, 2, 2, 1, 1, 1, 1, 2, 2, 2};
 
-    // Reset function's parameters to defaults
-    memset(function->selectFunction.name, '\0', sizeof(function->selectFunction.name));
+    // Function can be preceded by row selection
+    if ((errorInfo = getSelectFunctionFromArgs(&function->selectFunction, args, position)).error == true) {
+        return errorInfo;
+    }
 
     // Find function
-    for (int j = 0; j < (int)(sizeof(functions) / sizeof(char**)); j++) {
-        if (streq(args->data[*position], functions[j])) {
-            strcpy(function->name, functions[j]);
-
-            // Prepare arguments for the function
-            for (int i = 0; i < funcArgs[j]; i++) {
-                int index = *position + i + 1; // Index of argument in InputArguments
-                function->params[i] = toRowColNum(args->data[index], false);
-                if ((index >= args->size) || function->params[i] == INVALID_NUMBER) {
-                    // There is an exception... (function that accepts string value as one of its params)
-                    if (!(streq(function->name, "cset") && i == 1)) {
-                        errorInfo.error = true;
-                        errorInfo.message = "Chybne cislo radku/sloupce, povolena jsou cela cisla od 1.";
-
-                        return errorInfo;
-                    } else {
-                        memset(function->strParams[i], '\0', sizeof(function->strParams[i]));
-                        memmove(function->strParams[i], args->data[index], strlen(args->data[index]));
-                    }
-                }
-            }
+    int numberOfTypes = (int)(sizeof(functionDefinitions) / sizeof(FunctionDefinition));
+    for (int j = NO_FUNCTION + 1; j < numberOfTypes; j++) {
+        const FunctionDefinition *definition = &functionDefinitions[j];
+        if (!(streq(args->data[*position], definition->name))) {
+            continue;
+        }
 
-            // Move iterator of arguments array by function arguments
-            *position += funcArgs[j];
-            // Function was found, doesn't make sense to continue searching
-            return errorInfo;
-        } else if (streq(args->data[*position], "rows")) {
-            // Select interval of rows
-            SelectFunction selection = {.name = "rows"};
-            if ((selection.params[0] = toRowColNum(args->data[++(*position)], true)) == INVALID_NUMBER) {
+        function->type = (FunctionType)j;
+
+        // Prepare arguments for the function
+        for (int i = 0; i < definition->numberOfParams; i++) {
+            int index = *position + i + 1; // Index of argument in InputArguments
+            if (index >= args->size) {
                 errorInfo.error = true;
-                errorInfo.message = "Chybne cislo ve vyberu pocatecniho radku, povolena jsou cela cisla od 1.";
+                errorInfo.message = "Funkci chybi nektery z povinnych parametru.";
 
                 return errorInfo;
             }
 
-            if ((selection.params[1] = toRowColNum(args->data[++(*position)], true)) == INVALID_NUMBER) {
+            // There is an exception... (function that accepts string value as one of its params)
+            if (function->type == CSET && i == 1) {
+                function->value = args->data[index];
+            } else if ((function->params[i] = toRowColNum(args->data[index], false)) == INVALID_NUMBER) {
                 errorInfo.error = true;
-                errorInfo.message = "Chybne cislo ve vyberu koncoveho radku, povolena jsou cela cisla od 1 a '-'.";
+                errorInfo.message = "Chybne cislo radku/sloupce, povolena jsou cela cisla od 1.";
 
                 return errorInfo;
             }
+        }
 
-            if (selection.params[1] != LAST_ROW_NUMBER && selection.params[1] < selection.params[0]) {
-                errorInfo.error = true;
-                errorInfo.message = "Chybne poradi argumentu funkce rows, prvni cislo musi byt mensi nebo rovno.";
+        // Case of more columns can be changed at once, so there can be an optional number of the last column
+        if (function->type == TOLOWER || function->type == TOUPPER) {
+            int index = *position + definition->numberOfParams + 1;
+            int last = index < args->size ? toRowColNum(args->data[index], false) : INVALID_NUMBER;
+            if (last == INVALID_NUMBER) {
+                function->params[1] = function->params[0];
+            } else {
+                function->params[1] = last;
+                (*position)++;
+            }
+        }
 
-                return errorInfo;
+        // More new rows can be added at once, so there can be an optional count of them
+        if (function->type == IROW || function->type == AROW) {
+            int index = *position + definition->numberOfParams + 1;
+            int count = index < args->size ? toRowColNum(args->data[index], false) : INVALID_NUMBER;
+            if (count == INVALID_NUMBER) {
+                function->params[definition->numberOfParams] = 1;
+            } else {
+                function->params[definition->numberOfParams] = count;
+                (*position)++;
             }
+        }
 
-            // Save selection a move position to next function
-            function->selectFunction = selection;
-            (*position)++;
+        // Move iterator of arguments array by function arguments
+        *position += definition->numberOfParams;
+        // Function was found, doesn't make sense to continue searching
+        return errorInfo;
+    }
+
+    // Function not found --> function name must be bad
+    errorInfo.error = true;
+    errorInfo.message = "Neplatny nazev funkce.";
+
+    return errorInfo;
+}
+
+/**
+ * Extract row selection function from program input arguments
+ * @param selection Pointer for save found selection (type is ALL_ROWS if there is no selection)
+ * @param args Input program arguments
+ * @param position Actual position in input program arguments (moved to the function the selection is for)
+ * @return Error information
+ */
+ErrorInfo getSelectFunctionFromArgs(SelectFunction *selection, const InputArguments *args, int *position) {
+    ErrorInfo errorInfo = {false};
+
+    // Selections can be chained, the last one is used
+    selection->type = ALL_ROWS;
+    while (true) {
+        if (streq(args->data[*position], "rows")) {
+            selection->type = ROWS;
         } else if (streq(args->data[*position], "beginswith")) {
-            // Select rows begin with something
-            SelectFunction selection = {.name = "beginswith"};
+            selection->type = BEGINS_WITH;
+        } else if (streq(args->data[*position], "contains")) {
+            selection->type = CONTAINS;
+        } else {
+            return errorInfo;
+        }
+
+        // Selection function has 2 parameters and after them there must be a function the selection is for
+        if (*position + 3 >= args->size) {
+            errorInfo.error = true;
+            errorInfo.message = "Funkci pro vyber radku chybi parametry nebo funkce, na kterou se vyber aplikuje.";
+
+            return errorInfo;
+        }
 
-            if ((selection.params[0] = toRowColNum(args->data[++(*position)], false)) == INVALID_NUMBER) {
+        if (selection->type == ROWS) {
+            // Select interval of rows
+            if ((selection->params[0] = toRowColNum(args->data[++(*position)], true)) == INVALID_NUMBER) {
                 errorInfo.error = true;
-                errorInfo.message = "Chybne cislo ve vyberu sloupce, povolena jsou cela cisla od 1.";
+                errorInfo.message = "Chybne cislo ve vyberu pocatecniho radku, povolena jsou cela cisla od 1.";
 
                 return errorInfo;
             }
 
-            (*position)++;
-            memmove(selection.strParams[1], args->data[*position], strlen(args->data[*position]));
+            if ((selection->params[1] = toRowColNum(args->data[++(*position)], true)) == INVALID_NUMBER) {
+                errorInfo.error = true;
+                errorInfo.message = "Chybne cislo ve vyberu koncoveho radku, povolena jsou cela cisla od 1 a '-'.";
 
-            // Save selection a move position to next function
-            function->selectFunction = selection;
-            (*position)++;
-        } else if (streq(args->data[*position], "contains")) {
-            // Select rows contain something
-            SelectFunction selection = {.name = "contains"};
+                return errorInfo;
+            }
 
-            if ((selection.params[0] = toRowColNum(args->data[++(*position)], false)) == INVALID_NUMBER) {
+            if (selection->params[1] != LAST_ROW_NUMBER && selection->params[1] < selection->params[0]) {
                 errorInfo.error = true;
-                errorInfo.message = "Chybne cislo ve vyberu sloupce, povolena jsou cela cisla od 1.";
+                errorInfo.message = "Chybne poradi argumentu funkce rows, prvni cislo musi byt mensi nebo rovno.";
 
                 return errorInfo;
             }
+        } else {
+            // Select rows begin with or contain something
+            if ((selection->params[0] = toRowColNum(args->data[++(*position)], false)) == INVALID_NUMBER) {
+                errorInfo.error = true;
+                errorInfo.message = "Chybne cislo ve vyberu sloupce, povolena jsou cela cisla od 1.";
 
-            (*position)++;
-            memmove(selection.strParams[1], args->data[*position], strlen(args->data[*position]));
+                return errorInfo;
+            }
 
-            // Save selection a move position to next function
-            function->selectFunction = selection;
-            (*position)++;
-        } else {
-            memset(function->name, '\0', sizeof(function->name));
+            // Size of the value is needed for every row, so it's computed only once
+            selection->value = args->data[++(*position)];
+            selection->params[1] = (int)strlen(selection->value);
         }
-    }
-
-    // Function not found --> function name must be bad
-    errorInfo.error = true;
-    errorInfo.message = "Neplatny nazev funkce.";
 
-    return errorInfo;
+        // Move position to the next function (selection or the function the selection is for)
+        (*position)++;
+    }
 }
 
 /**
@@ -1149,91 +5461,370 @@ int toRowColNum(char *value, bool specialAllowed) {
 }
 
 /**
- * Returns value of the selected column
- * @param Pointer to save value of the selected column (without '\n')
+ * Checks if the cell contains the value
+ * @param row Row contains the cell
+ * @param column Number of the cell's column (column that doesn't exist has empty value)
+ * @param value Searched value
+ * @param valueSize Size of the value
+ * @return Does the cell contain the value?
+ */
+bool cellContains(const Row *row, int column, const char *value, int valueSize) {
+    if (valueSize == 0) {
+        return true;
+    }
+
+    if (column > row->numberOfCells) {
+        return false;
+    }
+
+    const char *cell = &row->data[getCellStart(row, column)];
+    int cellSize = getCellSize(row, column);
+    int i = 0;
+#ifdef X86_SIMD
+    // Longer values are searched by blocks, only the rest of the cell is searched char by char
+    if (valueSize > 1 && findValueSse2(cell, cellSize, value, valueSize, &i) == true) {
+        return true;
+    }
+#endif
+
+    for (; i + valueSize <= cellSize; i++) {
+        // Candidates start with the first char of the value
+        const char *candidate = memchr(&cell[i], value[0], cellSize - valueSize - i + 1);
+        if (candidate == NULL) {
+            return false;
+        }
+
+        i = (int)(candidate - cell);
+        if (memcmp(candidate, value, valueSize) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#ifdef X86_SIMD
+/**
+ * Searches the value in the cell by blocks of 16 positions (candidates must match the first and the last char of the
+ * value, only these are compared whole)
+ * @param cell Start of the cell
+ * @param cellSize Size of the cell
+ * @param value Searched value (at least 2 chars long)
+ * @param valueSize Size of the value
+ * @param checked Number of positions (from the start of the cell) that were checked
+ * @return Was the value found?
+ */
+__attribute__((target("sse2")))
+bool findValueSse2(const char *cell, int cellSize, const char *value, int valueSize, int *checked) {
+    const __m128i firstChar = _mm_set1_epi8(value[0]);
+    const __m128i lastChar = _mm_set1_epi8(value[valueSize - 1]);
+
+    int i = 0;
+    for (; i + valueSize - 1 + 16 <= cellSize; i += 16) {
+        __m128i firstChars = _mm_loadu_si128((const __m128i *) &cell[i]);
+        __m128i lastChars = _mm_loadu_si128((const __m128i *) &cell[i + valueSize - 1]);
+        unsigned int mask = _mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(firstChars, firstChar), _mm_cmpeq_epi8(lastChars, lastChar)));
+
+        while (mask != 0) {
+            int candidate = i + __builtin_ctz(mask);
+            if (memcmp(&cell[candidate + 1], &value[1], valueSize - 2) == 0) {
+                return true;
+            }
+
+            mask &= mask - 1;
+        }
+    }
+
+    *checked = i;
+
+    return false;
+}
+#endif
+
+/**
+ * Returns copy of value of the selected column
  * @param row Row contains the column
  * @param columnNumber Number of selected column
- * @param delimiter Column delimiter
+ * @return Value of the column (valid until the next row is loaded) or NULL if there isn't enough memory
  */
-void getColumnValue(char *value, const Row *row, int columnNumber, char delimiter, int numberOfColumns) {
-    memset(value, '\0', MAX_CELL_SIZE);
-
+char *getColumnValue(Row *row, int columnNumber) {
     // Column that doesn't exists, so it doesn't have any value
-    if (columnNumber > numberOfColumns) {
-        return;
+    int size = columnNumber > row->numberOfCells ? 0 : getCellSize(row, columnNumber);
+
+    char *value = allocateRowMemory(row, size + 1);
+    if (value == NULL) {
+        return NULL;
     }
 
-    int counter = 1;
-    int j = 0;
-    for (int i = 0; i < row->size; i++) {
-        // \n is "delimiter" for the last column
-        if ((row->data[i] == delimiter) || (row->data[i] == '\n')) {
-            counter++;
-        } else if (counter == columnNumber) {
-            value[j] = row->data[i];
-            j++;
-        }
+    if (size > 0) {
+        memcpy(value, &row->data[getCellStart(row, columnNumber)], size);
     }
+    value[size] = '\0';
+
+    return value;
 }
 
 /**
- * Sets value of selected column
- * @param value New column's value
+ * Sets value of selected column (cell of read-only row is only overridden, so the row isn't copied)
+ * @param value New column's value (it must be valid until the row is written, e.g. in row's memory or in arguments)
  * @param row Row contains the column
  * @param columnNumber Column's number
- * @param delimiter Column delimiter
- * @param numberOfColumns Number of column in the row
  */
-void setColumnValue(const char *value, Row *row, int columnNumber, char delimiter, int numberOfColumns) {
+void setColumnValue(const char *value, Row *row, int columnNumber) {
     // Can't be applied because the column doesn't exists
-    if (columnNumber > numberOfColumns) {
+    if (columnNumber > row->numberOfCells) {
         return;
     }
 
-    // Backup row data
-    char rowBackup[MAX_ROW_SIZE];
-    for (int i = 0; i < MAX_ROW_SIZE; i++) {
-        rowBackup[i] = row->data[i];
+    int start = getCellStart(row, columnNumber);
+    int oldSize = getCellSize(row, columnNumber);
+    int valueSize = (int)strlen(value);
+
+    // The same value doesn't have to be written (overridden cell has already got other value)
+    bool overridden = false;
+    for (int i = 0; i < row->numberOfOverrides; i++) {
+        overridden = overridden == true || row->overrides[i].column == columnNumber;
+    }
+    if (overridden == false && valueSize == oldSize && memcmp(&row->data[start], value, valueSize) == 0) {
+        return;
     }
 
-    int counter = 1;
-    int backupIndex, dataIndex;
-    for (dataIndex = backupIndex = 0; dataIndex < MAX_ROW_SIZE;) {
-        if (counter == columnNumber) {
-            // Replace row data with new value's content
-            int i = 0;
-            while (value[i] != '\0') {
-                row->data[i + dataIndex] = value[i];
-                i++;
-            }
-            // Move index of row data to a new position (new value can has diff length)
-            dataIndex = backupIndex + i;
+    if (row->readOnly == true) {
+        if (overrideCell(row, columnNumber, value, valueSize) == true) {
+            return;
+        }
 
-            // Delimiter is after the end of normal column, \n is at the end of the last column
-            while ((rowBackup[backupIndex] != delimiter) && (rowBackup[backupIndex] != '\n')) {
-                backupIndex++;
-            }
+        // Too many changes, the whole row is moved to its storage
+        applyCellOverrides(row);
+        if (row->outOfMemory == true) {
+            return;
+        }
+
+        start = getCellStart(row, columnNumber);
+        oldSize = getCellSize(row, columnNumber);
+    }
+
+    replaceRowData(row, start, start + oldSize, value, valueSize);
+    if (row->outOfMemory == true) {
+        return;
+    }
+
+    // Next cells are moved by the difference of sizes
+    for (int i = columnNumber; i <= row->numberOfCells; i++) {
+        row->cells[i] += valueSize - oldSize;
+    }
+}
+
+/**
+ * Overrides cell of read-only row with new value (see writeProcessedRow())
+ * @param row Read-only row
+ * @param columnNumber Number of the overridden cell
+ * @param value New value of the cell (it isn't copied, see setColumnValue())
+ * @param valueSize Size of the new value
+ * @return Was the cell overridden? If false, all overrides are used.
+ */
+bool overrideCell(Row *row, int columnNumber, const char *value, int valueSize) {
+    CellOverride *override = NULL;
+    for (int i = 0; i < row->numberOfOverrides; i++) {
+        if (row->overrides[i].column == columnNumber) {
+            override = &row->overrides[i];
+        }
+    }
+
+    if (override == NULL && row->numberOfOverrides == MAX_CELL_OVERRIDES) {
+        return false;
+    }
+
+    if (override == NULL) {
+        override = &row->overrides[row->numberOfOverrides++];
+    }
+    override->column = columnNumber;
+    override->value = value;
+    override->size = valueSize;
+
+    return true;
+}
+
+/**
+ * Writes overridden cells into row's data (the row is moved to its storage)
+ * @param row Read-only row with overridden cells
+ */
+void applyCellOverrides(Row *row) {
+    CellOverride overrides[MAX_CELL_OVERRIDES];
+    int numberOfOverrides = row->numberOfOverrides;
+    memcpy(overrides, row->overrides, sizeof(overrides));
+    row->numberOfOverrides = 0;
+
+    if (moveRowToStorage(row, row->size) == false) {
+        return;
+    }
+
+    for (int i = 0; i < numberOfOverrides && row->outOfMemory == false; i++) {
+        setColumnValue(overrides[i].value, row, overrides[i].column);
+    }
+}
+
+/**
+ * Replaces part of row's data with new content (only data after the replaced part are moved)
+ * @param row Row to change (its cells' index isn't updated, it's caller's responsibility)
+ * @param start Index of the first replaced char
+ * @param end Index after the last replaced char (start for inserting the value without replacing)
+ * @param value New content (NULL for deleting the part)
+ * @param valueSize Number of chars in the new content
+ */
+void replaceRowData(Row *row, int start, int end, const char *value, int valueSize) {
+    int newSize = row->size + valueSize - (end - start);
+
+    // Row in input buffer can't grow (the next row is right after it), so it's moved to its own storage
+    if (row->readOnly == true
+        || (newSize > row->size && (row->data != row->storage || newSize > row->storageCapacity))) {
+        if (moveRowToStorage(row, newSize) == false) {
+            return;
+        }
+    }
+
+    memmove(&row->data[start + valueSize], &row->data[end], row->size - end);
+    if (valueSize > 0) {
+        memcpy(&row->data[start], value, valueSize);
+    }
+
+    row->size = newSize;
+}
+
+/**
+ * Moves row's data to row's own storage, so they can be freely changed
+ * @param row Row to move
+ * @param size Required size of the storage (at least the size of the row)
+ * @return Was it successful? If false, there isn't enough memory (see Row.outOfMemory).
+ */
+bool moveRowToStorage(Row *row, int size) {
+    if (row->storage == NULL || row->storageCapacity < size) {
+        // Storage is bigger than needed, so it doesn't have to be reallocated for every small change
+        int capacity = 2 * size;
+        char *storage = allocateRowMemory(row, capacity);
+        if (storage == NULL) {
+            return false;
         }
 
-        // Loading unchanged data from backup
-        row->data[dataIndex] = rowBackup[backupIndex];
+        memcpy(storage, row->data, row->size);
+        row->storage = storage;
+        row->storageCapacity = capacity;
+    } else if (row->data != row->storage) {
+        memcpy(row->storage, row->data, row->size);
+    }
+
+    row->data = row->storage;
+    row->readOnly = false;
+
+    return true;
+}
+
+/**
+ * Prepares space in the index of row's cells
+ * @param row Row to prepare
+ * @param numberOfCells Number of cells that must fit into the index
+ * @return Was it successful? If false, there isn't enough memory (see Row.outOfMemory).
+ */
+bool reserveRowCells(Row *row, int numberOfCells) {
+    // The end of the last cell is stored after the cells
+    if (row->cellsCapacity > numberOfCells) {
+        return true;
+    }
+
+    int capacity = 2 * row->cellsCapacity > numberOfCells + 1 ? 2 * row->cellsCapacity : numberOfCells + 1;
+    int *cells = allocateRowMemory(row, capacity * sizeof(int));
+    if (cells == NULL) {
+        return false;
+    }
+
+    if (row->cells != NULL) {
+        memcpy(cells, row->cells, (row->numberOfCells + 1) * sizeof(int));
+    }
+    row->cells = cells;
+    row->cellsCapacity = capacity;
+
+    return true;
+}
+
+/**
+ * Allocates memory for row's data (see allocateFromArena())
+ * @param row Row to allocate memory for
+ * @param size Number of bytes to allocate
+ * @return Allocated memory or NULL if there isn't enough memory (Row.outOfMemory is set)
+ */
+void *allocateRowMemory(Row *row, size_t size) {
+    void *memory = allocateFromArena(row->arena, size);
+    if (memory == NULL) {
+        row->outOfMemory = true;
+    }
+
+    return memory;
+}
+
+/**
+ * Allocates memory from arena (it's valid until the arena is reset)
+ * @param arena Arena to allocate from
+ * @param size Number of bytes to allocate
+ * @return Allocated memory or NULL if there isn't enough memory
+ */
+void *allocateFromArena(Arena *arena, size_t size) {
+    // Allocated memory is aligned for any type stored in rows
+    size = (size + sizeof(size_t) - 1) / sizeof(size_t) * sizeof(size_t);
+
+    ArenaBlock *block = arena->block;
+    if (block == NULL || block->capacity - block->used < size) {
+        size_t capacity = block != NULL ? 2 * block->capacity : ARENA_BLOCK_SIZE;
+        while (capacity < size) {
+            capacity *= 2;
+        }
 
-        // Mark next column
-        if ((rowBackup[backupIndex] == delimiter) || (rowBackup[backupIndex] == '\n')) {
-            counter++;
+        ArenaBlock *newBlock = malloc(sizeof(ArenaBlock) + capacity);
+        if (newBlock == NULL) {
+            return NULL;
         }
 
-        dataIndex++;
-        backupIndex++;
+        newBlock->previous = block;
+        newBlock->capacity = capacity;
+        newBlock->used = 0;
+        arena->block = block = newBlock;
+    }
+
+    void *memory = &block->memory[block->used];
+    block->used += size;
+
+    return memory;
+}
+
+/**
+ * Resets arena, so its memory can be used again (all previously allocated memory is invalid)
+ * @param arena Arena to reset
+ */
+void resetArena(Arena *arena) {
+    if (arena->block == NULL) {
+        return;
     }
 
-    // Function removes \n in the last column, so put it back
-    if (columnNumber == numberOfColumns) {
-        row->data[dataIndex] = '\n';
+    // Only the biggest (the last) block is kept, it's enough for data of similar size
+    ArenaBlock *block = arena->block->previous;
+    while (block != NULL) {
+        ArenaBlock *previous = block->previous;
+        free(block);
+        block = previous;
     }
 
-    // Count new size after changes
-    row->size = (int)strlen(row->data);
+    arena->block->previous = NULL;
+    arena->block->used = 0;
+}
+
+/**
+ * Frees all memory of arena
+ * @param arena Arena to free
+ */
+void freeArena(Arena *arena) {
+    resetArena(arena);
+    free(arena->block);
+    arena->block = NULL;
 }
 
 /**
@@ -1243,7 +5834,7 @@ void setColumnValue(const char *value, Row *row, int columnNumber, char delimite
  */
 bool isValidNumber(char *number) {
     bool decimalPoint = false; // Was decimal point found?
-    for (int i = 0; i < (int) strlen(number); i++) {
+    for (int i = 0; number[i] != '\0'; i++) {
         if (((number[i] < '0') || (number[i] > '9')) && (i == 0 && (number[i] != '-'))) {
             if (number[i] == '.' && decimalPoint == false) {
                 decimalPoint = true;
@@ -1254,4 +5845,130 @@ bool isValidNumber(char *number) {
     }
 
     return true;
+}
+
+/**
+ * Validates and parses plain decimal number (e.g. -12.345) in one pass, independently on locale
+ * @param value Value to parse (it doesn't have to be terminated)
+ * @param size Size of the value
+ * @param number Found parts of the number
+ * @return Is the value plain decimal number with at most MAX_EXACT_DIGITS digits?
+ */
+bool scanDecimalNumber(const char *value, int size, DecimalNumber *number) {
+    int i = 0;
+    number->negative = size > 0 && value[0] == '-';
+    if (number->negative == true) {
+        i++;
+    }
+
+    number->integerPart = &value[i];
+    while (i < size && value[i] >= '0' && value[i] <= '9') {
+        i++;
+    }
+    number->integerSize = (int)(&value[i] - number->integerPart);
+
+    number->decimalPart = &value[i];
+    if (i < size && value[i] == '.') {
+        number->decimalPart = &value[++i];
+        while (i < size && value[i] >= '0' && value[i] <= '9') {
+            i++;
+        }
+    }
+    number->decimalSize = (int)(&value[i] - number->decimalPart);
+
+    // Whole value must be the number
+    int digits = number->integerSize + number->decimalSize;
+
+    return i == size && digits > 0 && digits <= MAX_EXACT_DIGITS;
+}
+
+/**
+ * Formats number rounded to integer the same way as printf("%.f") does (half is rounded to even)
+ * @param number Parsed number (see scanDecimalNumber())
+ * @param result Buffer for the result (it must have space for all digits, sign, carry and \0)
+ * @return Size of the result
+ */
+int formatRoundedNumber(const DecimalNumber *number, char *result) {
+    int size = 0;
+
+    // Sign is kept even for numbers rounded to zero
+    if (number->negative == true) {
+        result[size++] = '-';
+    }
+
+    // Leading zeros aren't written
+    const char *digits = number->integerPart;
+    int digitsSize = number->integerSize;
+    while (digitsSize > 0 && digits[0] == '0') {
+        digits++;
+        digitsSize--;
+    }
+
+    bool roundUp = false;
+    if (number->decimalSize > 0 && number->decimalPart[0] > '5') {
+        roundUp = true;
+    } else if (number->decimalSize > 0 && number->decimalPart[0] == '5') {
+        // Exact half is rounded to even number
+        roundUp = digitsSize > 0 && (digits[digitsSize - 1] - '0') % 2 == 1;
+        for (int i = 1; i < number->decimalSize && roundUp == false; i++) {
+            roundUp = number->decimalPart[i] != '0';
+        }
+    }
+
+    // The first position is reserved for carry
+    int carry = size;
+    result[carry] = '0';
+    memcpy(&result[carry + 1], digits, digitsSize);
+    size = carry + 1 + digitsSize;
+
+    if (roundUp == true) {
+        int i = size - 1;
+        while (i > carry && result[i] == '9') {
+            result[i--] = '0';
+        }
+        result[i]++;
+    }
+
+    // Unused carry isn't written (except zero without any other digits)
+    if (result[carry] == '0' && size > carry + 1) {
+        memmove(&result[carry], &result[carry + 1], size - carry - 1);
+        size--;
+    }
+    result[size] = '\0';
+
+    return size;
+}
+
+/**
+ * Formats integer part of the number the same way as printf("%d") does for the number converted to integer
+ * @param number Parsed number (see scanDecimalNumber())
+ * @param result Buffer for the result (it must have space for all digits, sign and \0)
+ * @return Size of the result
+ */
+int formatIntegerPart(const DecimalNumber *number, char *result) {
+    // Leading zeros aren't written
+    const char *digits = number->integerPart;
+    int digitsSize = number->integerSize;
+    while (digitsSize > 0 && digits[0] == '0') {
+        digits++;
+        digitsSize--;
+    }
+
+    // Zero doesn't have sign
+    if (digitsSize == 0) {
+        strcpy(result, "0");
+
+        return 1;
+    }
+
+    int size = 0;
+    if (number->negative == true) {
+        result[size++] = '-';
+    }
+
+    memcpy(&result[size], digits, digitsSize);
+    size += digitsSize;
+    result[size] = '\0';
+
+    return size;
 }
\ No newline at end of file
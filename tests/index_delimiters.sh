@@ -0,0 +1,29 @@
+#!/bin/sh
+# Rows copied through the row index (--index) must have other delimiters unified as without the index
+# Usage: index_delimiters.sh SHEET
+
+sheet="$1"
+dir=$(mktemp -d) || exit 1
+trap 'rm -rf "$dir"' EXIT
+
+printf 'a:b\nc;d\ne,f\n1;2\n3,4\n' > "$dir/table.txt"
+
+status=0
+for functions in "drow 1" "drows 2 3" "irow 2" "rows 2 2 cset 1 x" "rows 4 - tolower 2"; do
+    # shellcheck disable=SC2086
+    "$sheet" -d ':;,' -f "$dir/table.txt" $functions > "$dir/expected.txt" || status=1
+
+    # The first run builds the index, the second one reuses it
+    rm -f "$dir/table.ix"
+    for run in build reuse; do
+        # shellcheck disable=SC2086
+        "$sheet" -d ':;,' -f "$dir/table.txt" --index "$dir/table.ix" $functions > "$dir/actual.txt" || status=1
+        if ! cmp -s "$dir/expected.txt" "$dir/actual.txt"; then
+            echo "Different output with --index ($run): $functions"
+            diff "$dir/expected.txt" "$dir/actual.txt"
+            status=1
+        fi
+    done
+done
+
+exit $status
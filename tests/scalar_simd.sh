@@ -0,0 +1,53 @@
+#!/bin/sh
+# Scalar kernels (DISABLE_SIMD) are the reference, SIMD kernels must give identical output
+# Usage: scalar_simd.sh SHEET SHEET_SCALAR
+
+sheet="$1"
+scalar="$2"
+dir=$(mktemp -d) || exit 1
+trap 'rm -rf "$dir"' EXIT
+
+# Table with the given delimiters (the first one is the main one, others are used randomly), rows of various lengths
+generate() {
+    awk -v delimiters="$1" 'BEGIN {
+        srand(2020)
+        letters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJ"
+        for (row = 0; row < 20000; row++) {
+            line = sprintf("%d.%02d", int(rand() * 100000), int(rand() * 100))
+            for (column = 1; column < 8; column++) {
+                delimiter = substr(delimiters, 1, 1)
+                if (length(delimiters) > 1 && rand() < 0.25) {
+                    delimiter = substr(delimiters, 2 + int(rand() * (length(delimiters) - 1)), 1)
+                }
+                cell = ""
+                width = 1 + int(rand() * (row % 50 == 0 ? 200 : 8))
+                for (i = 0; i < width; i++) {
+                    cell = cell substr(letters, 1 + int(rand() * length(letters)), 1)
+                }
+                line = line delimiter cell
+            }
+            print line
+        }
+    }' > "$dir/table.txt"
+}
+
+status=0
+for delimiters in " " ":;," ":;,|!#%&*+=@"; do
+    generate "$delimiters"
+    for options in "" "--validate-first" "-j 3" "--pipeline"; do
+        for functions in "cset 2 x" "tolower 2 4" "round 1" "int 1" "copy 1 3" "swap 2 4" "move 5 1" \
+                         "contains 3 ab cset 1 y" "beginswith 2 a toupper 2" "icol 2 dcols 4 5 acol" \
+                         "irow 1 drows 3 100 arow"; do
+            # shellcheck disable=SC2086
+            "$sheet" -d "$delimiters" $options -f "$dir/table.txt" $functions > "$dir/simd.txt" 2>&1
+            # shellcheck disable=SC2086
+            "$scalar" -d "$delimiters" $options -f "$dir/table.txt" $functions > "$dir/scalar.txt" 2>&1
+            if ! cmp -s "$dir/simd.txt" "$dir/scalar.txt"; then
+                echo "Different output of SIMD and scalar kernels: -d '$delimiters' $options $functions"
+                status=1
+            fi
+        done
+    done
+done
+
+exit $status